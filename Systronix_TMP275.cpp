@@ -7,6 +7,11 @@
 
 #include <Systronix_TMP275.h>
 
+// The host tests in extras/test define this to run an 'interrupt' at points inside the snapshot latch
+#ifndef TMP275_SNAPSHOT_HOOK
+#define		TMP275_SNAPSHOT_HOOK(point)
+#endif
+
 /**---------------------------< CONSTRUCTOR >----------------------------------
 
 	@brief  Instantiates a new TMP275 class to use the given base address
@@ -44,6 +49,12 @@ Systronix_TMP275::Systronix_TMP275 (void)
 	{
 	_base = TMP275_SLAVE_ADDR_0;
 	_base_clipped = false;						// since it's constant it must be OK
+	_pointer_reg = TMP275_TEMP_REG_PTR;			// power-on-reset values
+	_config_reg = TMP275_CFG_RES9;
+	_conversion_raw = 0;
+	_conversion_ms = 0;
+	_conversion_valid = false;
+	_start_step = TMP275_START_READ;
 	error.total_error_count = 0;				// clear the error counter
 	}
 
@@ -159,7 +170,7 @@ uint8_t Systronix_TMP275::init (uint8_t config)
 	if (SUCCESS != ret_val)
 		{
 //		Serial.printf ("275 lib init %s at base 0x%.2X failed with %s (0x%.2X)\r\n", _wire_name, _base, status_text[error.error_val], error.error_val);
-		error.exists = false;				// only place error.exists is set false
+		error.exists = false;				// only places error.exists is set false are here and fleet_init()
 		return ABSENT;
 		}
 
@@ -167,6 +178,146 @@ uint8_t Systronix_TMP275::init (uint8_t config)
 	}
 
 
+//---------------------------< C O N F I G _ V E R I F Y >----------------------------------------------------
+//
+// Read the config register and compare it to the shadow copy of the last value written.  OS always reads
+// as zero so it is not compared.
+// returns SUCCESS if they match, ABSENT or FAIL else
+//
+
+uint8_t Systronix_TMP275::config_verify (void)
+	{
+	uint8_t config;
+	uint8_t ret_val;
+
+	ret_val = config_read (&config);
+	if (SUCCESS != ret_val)
+		return ret_val;
+
+	return config_matches (config) ? SUCCESS : FAIL;
+	}
+
+
+//---------------------------< C O N F I G _ M A T C H E S >--------------------------------------------------
+//
+// true if a config value read from the device agrees with the shadow copy; OS always reads as zero
+//
+
+boolean Systronix_TMP275::config_matches (uint8_t config)
+	{
+	return ((config & ~TMP275_CFG_OS) == (_config_reg & ~TMP275_CFG_OS));
+	}
+
+
+//---------------------------< S H A D O W _ R E S E T >------------------------------------------------------
+//
+// The device has been reset: shadow registers return to power-up values and the conversion history is
+// forgotten, so the next read is taken as a new conversion and is not held off by the old one.  data is
+// left alone; data.sequence keeps counting so that readers never see it go backwards.
+//
+
+void Systronix_TMP275::shadow_reset (void)
+	{
+	_pointer_reg = TMP275_TEMP_REG_PTR;
+	_config_reg = TMP275_CFG_POR;
+	_conversion_valid = false;
+	}
+
+
+//---------------------------< G E N E R A L _ C A L L _ R E S E T >------------------------------------------
+//
+// Send the general call reset command on this instance's Wire net.  All TMP275s on the net return to their
+// power-up register values.  Other devices that support general call will also reset, so use with care
+// on shared buses.  Only this instance's shadow copies are reset here, so this is protected: fleet_init(),
+// which resets the shadow copies of every sensor on the net, is the way in.
+// returns SUCCESS if any device acknowledged, FAIL else
+//
+
+uint8_t Systronix_TMP275::general_call_reset (void)
+	{
+	uint8_t ret_val;
+
+	_wire.beginTransmission (TMP275_GENERAL_CALL_ADDR);
+	ret_val = _wire.write (TMP275_GENERAL_CALL_RESET);
+	if (1 != ret_val)
+		{
+		i2c_common.tally_transaction (WR_INCOMPLETE, &error);			// increment the appropriate counter
+		return FAIL;
+		}
+
+	bus_tally (2);									// address + command
+	ret_val = _wire.endTransmission();
+	if (SUCCESS != ret_val)
+		{
+		i2c_common.tally_transaction (ret_val, &error);				// increment the appropriate counter
+		return FAIL;								// calling function decides what to do with the error
+		}
+
+	shadow_reset ();								// device registers are now at power-up values
+
+	i2c_common.tally_transaction (SUCCESS, &error);
+	return SUCCESS;
+	}
+
+
+//---------------------------< F L E E T _ I N I T >----------------------------------------------------------
+/**
+Reset and configure count sensors that share one Wire net, for startup or recovery of a wedged group.
+
+One general call reset (sent through sensors[0]) returns every sensor to power-up values in a single
+transaction.  If config is the power-up value nothing more is written; otherwise each sensor gets one
+config write since the TMP275 has no broadcast register write.  Every sensor's config register is then
+read back and checked against its shadow copy.
+
+Sensors that don't answer the config write or the read back are marked as not existing, as init() does.
+A sensor that answers with the wrong config value still exists but makes the return FAIL.
+
+returns SUCCESS if every sensor was configured and verified, FAIL else
+**/
+
+uint8_t Systronix_TMP275::fleet_init (Systronix_TMP275* sensors[], uint8_t count, uint8_t config)
+	{
+	uint8_t ret_val = SUCCESS;
+	uint8_t readback;
+
+	if (0 == count)
+		return SUCCESS;
+
+	if (SUCCESS != sensors[0]->general_call_reset ())
+		return FAIL;
+
+	for (uint8_t i = 0; i < count; i++)
+		{
+		Systronix_TMP275* sensor = sensors[i];
+
+		sensor->shadow_reset ();					// the reset reached every sensor on the net
+		sensor->error.exists = true;				// we'll find out below if device does not exist
+
+		if (TMP275_CFG_POR != config)
+			{
+			if (SUCCESS != sensor->config_write (config))
+				{
+				sensor->error.exists = false;
+				ret_val = FAIL;
+				continue;
+				}
+			}
+
+		if (SUCCESS != sensor->config_read (&readback))
+			{
+			sensor->error.exists = false;			// didn't answer
+			ret_val = FAIL;
+			continue;
+			}
+
+		if (!sensor->config_matches (readback))
+			ret_val = FAIL;
+		}
+
+	return ret_val;
+	}
+
+
 //---------------------------< R E S E T _ B U S >------------------------------------------------------------
 /**
 	Invoke resetBus of whichever Wire net this class instance is using
@@ -225,29 +376,496 @@ float Systronix_TMP275::raw12_to_f (uint16_t raw12)
 
 //---------------------------< G E T _ T E M P E R A T U R E _ D A T A >--------------------------------------
 //
-// Gets current temperature and fills the data struct with the various temperature info
+// Gets current temperature and fills the data struct with the various temperature info.
+// Returns SUCCESS for any good read; data.fresh tells if it returned a new conversion or the same one again.
 //
 
 uint8_t Systronix_TMP275::get_temperature_data (void)
 	{
+	data.fresh = false;									// until we have a new sample
+
 	if (_pointer_reg)									// if not pointed at temperature register
 		if (pointer_write (TMP275_TEMP_REG_PTR))		// attempt to point it
 			return FAIL;								// attempt failed; quit
 
+	if (UINT32_MAX > stats.reads_performed)
+		stats.reads_performed++;
+
 	if (register16_read (&data.raw_temp))				// attempt to read the temperature
 		return FAIL;									// attempt failed; quit
 
+	temperature_data_update ();
+	return SUCCESS;
+	}
+
+
+//---------------------------< G E T _ T E M P E R A T U R E _ D A T A _ S T A R T >--------------------------
+//
+// Non-blocking version of get_temperature_data() in three parts, so that transfers on several Wire nets can
+// be in flight at once.  _start() begins the transfer in the background (i2c_t3 completes it by interrupt
+// or DMA), _done() tells when it has finished, and _finish() collects the bytes and fills the data struct
+// just as get_temperature_data() does.
+//
+// If the pointer register is not pointed at the temperature register, _start() sends the pointer write in
+// the background instead and _done() begins the two byte read when that write has finished; the caller
+// sees one transfer either way.
+//
+// returns SUCCESS if the transfer was started, ABSENT or FAIL else
+//
+
+uint8_t Systronix_TMP275::get_temperature_data_start (void)
+	{
+	if (!error.exists)									// exit immediately if device does not exist
+		return ABSENT;
+
+	data.fresh = false;									// until we have a new sample
+
+	if (!_pointer_reg)									// already pointed at temperature register
+		{
+		temperature_request ();
+		return SUCCESS;
+		}
+
+	_wire.beginTransmission (_base);					// base address
+	if (1 != _wire.write (TMP275_TEMP_REG_PTR))			// pointer in 2 lsb
+		{
+		i2c_common.tally_transaction (WR_INCOMPLETE, &error);	// increment the appropriate counter
+		return FAIL;
+		}
+
+	bus_tally (2);										// address + pointer
+	_wire.sendTransmission (I2C_STOP);
+	_start_step = TMP275_START_POINTER;
+	return SUCCESS;
+	}
+
+
+//---------------------------< T E M P E R A T U R E _ R E Q U E S T >----------------------------------------
+//
+// begin the background read of the two temperature bytes; the pointer must already be set
+//
+
+void Systronix_TMP275::temperature_request (void)
+	{
+	if (UINT32_MAX > stats.reads_performed)
+		stats.reads_performed++;
+
+	bus_tally (3);										// address + 2 data
+	_wire.sendRequest (_base, 2, I2C_STOP);
+	_start_step = TMP275_START_READ;
+	}
+
+
+//---------------------------< G E T _ T E M P E R A T U R E _ D A T A _ D O N E >----------------------------
+//
+// true when the transfer begun by get_temperature_data_start() is no longer in progress.  When a background
+// pointer write finishes this begins the read and returns false.
+//
+
+boolean Systronix_TMP275::get_temperature_data_done (void)
+	{
+	uint8_t		ret_val;
+
+	if (!_wire.done())
+		return false;
+
+	if (TMP275_START_POINTER != _start_step)
+		return true;
+
+	ret_val = _wire.status();							// pointer write finished; did it work?
+	if (SUCCESS != ret_val)
+		{
+		i2c_common.tally_transaction (ret_val, &error);	// increment the appropriate counter
+		_start_step = TMP275_START_FAILED;
+		return true;
+		}
+
+	_pointer_reg = TMP275_TEMP_REG_PTR;					// update shadow copy to remember this setting
+	i2c_common.tally_transaction (SUCCESS, &error);
+
+	temperature_request ();
+	return false;
+	}
+
+
+//---------------------------< G E T _ T E M P E R A T U R E _ D A T A _ F I N I S H >------------------------
+//
+// Collect the result of get_temperature_data_start(); waits for the transfer if it is not yet done.
+// returns SUCCESS if no error, FAIL else
+//
+
+uint8_t Systronix_TMP275::get_temperature_data_finish (void)
+	{
+	uint8_t		ret_val;
+
+	while (!get_temperature_data_done ())				// returns immediately if already done
+		;
+
+	if (TMP275_START_FAILED == _start_step)				// pointer write failed; already tallied
+		return FAIL;
+
+	if (2 != _wire.available())
+		{
+		ret_val = _wire.status();						// to get error value
+		i2c_common.tally_transaction (ret_val, &error);	// increment the appropriate counter
+		return FAIL;
+		}
+
+	data.raw_temp = (uint16_t)_wire.readByte() << 8;	// save the data
+	data.raw_temp |= (uint16_t)_wire.readByte();
+
+	i2c_common.tally_transaction (SUCCESS, &error);		// increment the appropriate counter
+	temperature_data_update ();
+	return SUCCESS;
+	}
+
+
+//---------------------------< T E M P E R A T U R E _ D A T A _ U P D A T E >--------------------------------
+//
+// Decide whether a newly read data.raw_temp is a new conversion and if so fill in the rest of the data
+// struct and publish it.
+//
+// The part converts continuously and out of phase with our reads, so a read is taken to be a new conversion
+// only if raw_temp changed, or if the max conversion time has passed since the read that first returned the
+// last one (so at least one conversion must have completed, even if it gave the same value).  In shutdown
+// mode we can't know when the caller started a one-shot so every read is new.
+//
+
+void Systronix_TMP275::temperature_data_update (void)
+	{
+	uint32_t	now = millis();
+	boolean		new_conversion;
+
+	new_conversion = !_conversion_valid || (_config_reg & TMP275_CFG_SD) ||
+		(_conversion_raw != data.raw_temp) || (conversion_period_max_get() <= (uint32_t)(now - _conversion_ms));
+
+	if (!new_conversion)
+		return;											// same conversion; data.fresh already false
+
+	_conversion_raw = data.raw_temp;
+	_conversion_ms = now;
+	_conversion_valid = true;
+
 	data.t_high = max((int16_t)data.raw_temp, (int16_t)data.t_high);	// keep track of min/max temperatures
 	data.t_low = min((int16_t)data.t_low, (int16_t)data.raw_temp);
 
 	data.deg_c = raw12_to_c (data.raw_temp);			// convert to human-readable forms
 	data.deg_f = raw12_to_f (data.raw_temp);
 
+	data.capture_ms = now;
+	data.sequence++;
+
 	data.fresh = true;									// identify the current data set as new and fresh
+	snapshot_publish ();								// make the new sample visible to other contexts
+	threshold_check ();
+	}
+
+
+//---------------------------< T H R E S H O L D _ S E T >----------------------------------------------------
+/**
+Watch for the temperature crossing setpoint_c.  A rising event is queued when a sample is at or above the
+setpoint; a falling event when a sample is below setpoint_c - hysteresis_c.  Both are converted to raw12
+codes here so that samples are only compared as integers.
+
+A newly set threshold starts out 'below', so if the next sample is at or above the setpoint a rising event
+is queued for it.
+
+threshold_set() and threshold_clear() must be called from the same context as the get_...() calls; the
+thresholds and the no-crossing window are updated non-atomically.
+
+returns SUCCESS, or FAIL if index, setpoint or hysteresis is out of range (or NaN)
+**/
+
+uint8_t Systronix_TMP275::threshold_set (uint8_t index, float setpoint_c, float hysteresis_c)
+	{
+	uint16_t	set;
+	int32_t		clear;
+
+	if ((TMP275_THRESHOLDS <= index) || !((0.0f <= hysteresis_c) && (TMP275_HYSTERESIS_MAX_C >= hysteresis_c)))
+		return FAIL;									// written this way so NaN fails too
+
+	if (SUCCESS != degCToRaw12 (&set, &setpoint_c))
+		return FAIL;
+
+	clear = (int16_t)set - ((int32_t)(hysteresis_c * 16.0f + 0.5f) << 4);
+	if (INT16_MIN > clear)
+		return FAIL;
+
+	_threshold[index].set = (int16_t)set;
+	_threshold[index].clear = (int16_t)clear;
+	_threshold[index].above = false;
+	_threshold[index].active = true;
+
+	threshold_window_update ();
+	return SUCCESS;
+	}
+
+
+//---------------------------< T H R E S H O L D _ C L E A R >------------------------------------------------
+//
+// stop watching a threshold; events already queued for it stay in the queue.  Same context rule as
+// threshold_set().
+//
+
+uint8_t Systronix_TMP275::threshold_clear (uint8_t index)
+	{
+	if (TMP275_THRESHOLDS <= index)
+		return FAIL;
+
+	_threshold[index].active = false;
+	threshold_window_update ();
 	return SUCCESS;
 	}
 
 
+//---------------------------< T H R E S H O L D _ E V E N T _ G E T >----------------------------------------
+//
+// Remove the oldest threshold event from the queue; returns true if there was one.
+// Events are added by whichever context calls get_...(); one other context may remove them.
+//
+
+boolean Systronix_TMP275::threshold_event_get (threshold_event_t *event)
+	{
+	uint8_t		tail = _event_tail;
+
+	if (_event_head == tail)
+		return false;
+
+	__sync_synchronize();
+	*event = _events[tail];
+	__sync_synchronize();
+	_event_tail = (tail + 1) % TMP275_EVENTS;
+	return true;
+	}
+
+
+//---------------------------< T H R E S H O L D _ C H E C K >------------------------------------------------
+//
+// Compare a new sample against the active thresholds.  In the common case nothing is crossed and this is
+// just the two compares against the window; only when a sample leaves the window are the thresholds
+// examined one by one and events queued.
+//
+
+void Systronix_TMP275::threshold_check (void)
+	{
+	int16_t		raw = (int16_t)data.raw_temp;
+
+	if ((_threshold_low <= raw) && (_threshold_high > raw))
+		return;											// nothing crossed
+
+	for (uint8_t i = 0; i < TMP275_THRESHOLDS; i++)
+		{
+		threshold_t*	threshold = &_threshold[i];
+		uint8_t			head;
+		uint8_t			next;
+
+		if (!threshold->active)
+			continue;
+
+		if (threshold->above ? (threshold->clear <= raw) : (threshold->set > raw))
+			continue;									// this one not crossed
+
+		threshold->above = !threshold->above;
+
+		head = _event_head;
+		next = (head + 1) % TMP275_EVENTS;
+		if (next == _event_tail)
+			{
+			if (UINT32_MAX > stats.events_dropped)
+				stats.events_dropped++;
+			continue;
+			}
+
+		_events[head].threshold = i;
+		_events[head].rising = threshold->above;
+		_events[head].raw_temp = data.raw_temp;
+		_events[head].sequence = data.sequence;
+		__sync_synchronize();
+		_event_head = next;
+		}
+
+	threshold_window_update ();
+	}
+
+
+//---------------------------< T H R E S H O L D _ W I N D O W _ U P D A T E >--------------------------------
+//
+// Recompute the range of raw values that crosses no threshold: below the lowest setpoint of the thresholds
+// we are under, and at or above the highest clear point of the thresholds we are over.
+//
+
+void Systronix_TMP275::threshold_window_update (void)
+	{
+	_threshold_low = INT16_MIN;
+	_threshold_high = INT16_MAX;
+
+	for (uint8_t i = 0; i < TMP275_THRESHOLDS; i++)
+		{
+		if (!_threshold[i].active)
+			continue;
+
+		if (_threshold[i].above)
+			_threshold_low = max (_threshold_low, _threshold[i].clear);
+		else
+			_threshold_high = min (_threshold_high, _threshold[i].set);
+		}
+	}
+
+
+//---------------------------< G E T _ N E W _ T E M P E R A T U R E _ D A T A >------------------------------
+//
+// Same as get_temperature_data() except that the device is read only when the read is certain to return
+// a new conversion: once the max conversion time has passed since the read that first returned the last
+// one (see temperature_data_update()).  Otherwise the data struct is left as it is, data.fresh is set
+// false, and SUCCESS is returned.
+//
+// So no bus read is wasted on a repeat, at the cost of reading no more often than once per max conversion
+// time; in continuous 12-bit mode the part converts about every 220 ms and this reads about every 300 ms.
+// Use get_temperature_data() to read sooner.
+//
+// In shutdown (one-shot) mode we can't know when the caller started a conversion so always read.
+//
+
+uint8_t Systronix_TMP275::get_new_temperature_data (void)
+	{
+	if (!error.exists)									// exit immediately if device does not exist
+		return ABSENT;
+
+	if (!conversion_due ())
+		{
+		data.fresh = false;								// cached sample; not new
+		if (UINT32_MAX > stats.reads_skipped)
+			stats.reads_skipped++;
+		return SUCCESS;
+		}
+
+	return get_temperature_data ();
+	}
+
+
+//---------------------------< C O N V E R S I O N _ D U E >--------------------------------------------------
+//
+// true if a read now is certain to return a new conversion: the max conversion time has passed since the
+// last one was first read, or there is no sample since construction or a device reset, or in shutdown mode
+//
+
+boolean Systronix_TMP275::conversion_due (void)
+	{
+	if (!_conversion_valid || (_config_reg & TMP275_CFG_SD))
+		return true;
+
+	return (conversion_period_max_get() <= (uint32_t)(millis() - _conversion_ms));
+	}
+
+
+//---------------------------< C O N V E R S I O N _ P E R I O D _ G E T >------------------------------------
+//
+// return the typical conversion time in msec for the resolution last written to the config register
+//
+
+uint16_t Systronix_TMP275::conversion_period_get (void)
+	{
+	switch (_config_reg & TMP275_CFG_RES_MASK)
+		{
+		case TMP275_CFG_RES12:
+			return TMP275_CONV_MS_RES12;
+		case TMP275_CFG_RES11:
+			return TMP275_CONV_MS_RES11;
+		case TMP275_CFG_RES10:
+			return TMP275_CONV_MS_RES10;
+		default:
+			return TMP275_CONV_MS_RES9;
+		}
+	}
+
+
+//---------------------------< C O N V E R S I O N _ P E R I O D _ M A X _ G E T >----------------------------
+//
+// return the max conversion time in msec for the resolution last written to the config register
+//
+
+uint16_t Systronix_TMP275::conversion_period_max_get (void)
+	{
+	switch (_config_reg & TMP275_CFG_RES_MASK)
+		{
+		case TMP275_CFG_RES12:
+			return TMP275_CONV_MAX_MS_RES12;
+		case TMP275_CFG_RES11:
+			return TMP275_CONV_MAX_MS_RES11;
+		case TMP275_CFG_RES10:
+			return TMP275_CONV_MAX_MS_RES10;
+		default:
+			return TMP275_CONV_MAX_MS_RES9;
+		}
+	}
+
+
+//---------------------------< B U S _ T A L L Y >------------------------------------------------------------
+//
+// count one bus transaction of byte_count bytes, including the address byte; counters peg at max
+//
+
+void Systronix_TMP275::bus_tally (uint8_t byte_count)
+	{
+	if (UINT32_MAX > stats.bus_transactions)
+		stats.bus_transactions++;
+	if ((UINT32_MAX - byte_count) >= stats.bus_bytes)
+		stats.bus_bytes += byte_count;
+	else
+		stats.bus_bytes = UINT32_MAX;
+	}
+
+
+//---------------------------< S N A P S H O T _ P U B L I S H >----------------------------------------------
+//
+// Copy data into both snapshot slots, latch style.  Each increment of _snapshot_seq steers readers to the
+// slot that is not about to be written.  Only one writer (the context calling get_...()) is allowed.
+//
+
+void Systronix_TMP275::snapshot_publish (void)
+	{
+	_snapshot_seq++;									// odd: readers use _snapshot[1]
+	__sync_synchronize();
+	TMP275_SNAPSHOT_HOOK (0);
+	_snapshot[0] = data;
+	__sync_synchronize();
+	_snapshot_seq++;									// even: readers use _snapshot[0]
+	__sync_synchronize();
+	TMP275_SNAPSHOT_HOOK (1);
+	_snapshot[1] = data;
+	__sync_synchronize();
+	}
+
+
+//---------------------------< D A T A _ S N A P S H O T _ G E T >--------------------------------------------
+/**
+Copy the most recently published sample into *snapshot.  Lock-free and does not disable interrupts, so it
+may be called from an ISR or another task while get_temperature_data() is running.  The copy is retried
+only if the writer published a new sample while it was being made.
+
+snapshot->sequence identifies the sample; compare with a previous copy to see if it is new.
+
+returns SUCCESS, or FAIL if no sample has been published yet
+**/
+
+uint8_t Systronix_TMP275::data_snapshot_get (data_t *snapshot)
+	{
+	uint32_t	seq;
+
+	do
+		{
+		seq = _snapshot_seq;
+		__sync_synchronize();
+		*snapshot = _snapshot[seq & 1];
+		__sync_synchronize();
+		TMP275_SNAPSHOT_HOOK (2);
+		}
+	while (seq != _snapshot_seq);
+
+	return (snapshot->sequence) ? SUCCESS : FAIL;
+	}
+
+
 //---------------------------< P O I N T E R _ W R I T E >----------------------------------------------------
 /**
 Write to a TMP275 register
@@ -276,6 +894,7 @@ uint8_t Systronix_TMP275::pointer_write (uint8_t pointer)
 		return FAIL;
 		}
 
+	bus_tally (2);									// address + pointer
 	ret_val = _wire.endTransmission();
 	if (SUCCESS != ret_val)
 		{
@@ -313,6 +932,7 @@ uint8_t Systronix_TMP275::config_write (uint8_t config)
 		return FAIL;
 		}
 
+	bus_tally (3);									// address + pointer + config
 	ret_val = _wire.endTransmission();
 	if (SUCCESS != ret_val)
 		{
@@ -347,6 +967,7 @@ uint8_t Systronix_TMP275::config_read (uint8_t *data_ptr)
 			return FAIL;
 		}
 
+	bus_tally (2);									// address + config
 	if (1 != _wire.requestFrom (_base, 1, I2C_STOP))
 		{
 		ret_val = _wire.status();					// to get error value
@@ -386,6 +1007,7 @@ uint8_t Systronix_TMP275::register16_write (uint8_t pointer, uint16_t data)
 		return FAIL;
 		}
 
+	bus_tally (4);									// address + pointer + 2 data
 	ret_val = _wire.endTransmission();
 	if (SUCCESS != ret_val)
 		{
@@ -416,6 +1038,7 @@ uint8_t Systronix_TMP275::register16_read (uint16_t *data_ptr)
 	if (!error.exists)									// exit immediately if device does not exist
 		return ABSENT;
 
+	bus_tally (3);									// address + 2 data
 	if (2 != _wire.requestFrom (_base, 2, I2C_STOP))
 		{
 		ret_val = _wire.status();					// to get error value
@@ -447,15 +1070,36 @@ uint8_t Systronix_TMP275::tempReadDegC (float *tempC)
 
 //---------------------------< D E G C T O R A W 1 2 >--------------------------------------------------------
 /**
-Convert deg C float to a raw 13-bit temp value in TMP275 format.
-This is needed for Th and Tl registers as thermostat setpoint values
+Convert deg C float to a raw 12-bit temp value in TMP275 format, rounded to the nearest 0.0625 C.
+This is needed for Th and Tl registers as thermostat setpoint values, and for threshold_set()
 
-return 0 if OK, error codes if float is outside range of TMP275
+return SUCCESS if OK, FAIL if float is outside range of TMP275 (-55 to 127.9375 C) or NaN
 **/
 
 uint8_t Systronix_TMP275::degCToRaw12 (uint16_t *raw12, float *tempC)
 	{
-	return FAIL;
+	int16_t		counts;
+
+	// raw12 is 0.0625 C per count in the upper 12 bits, so 1/256 C per lsb of the 16-bit value
+	if (!(((TMP275_RAW12_MIN / 256.0f) <= *tempC) && ((TMP275_RAW12_MAX / 256.0f) >= *tempC)))
+		return FAIL;									// written this way so NaN fails too
+
+	counts = (int16_t)((*tempC * 16.0f) + ((0.0f > *tempC) ? -0.5f : 0.5f));	// 0.0625 C per count
+	*raw12 = (uint16_t)counts << 4;					// 12 bits in ms position
+	return SUCCESS;
+	}
+
+
+//---------------------------< D E G F T O R A W 1 2 >--------------------------------------------------------
+//
+// Convert deg F float to a raw 12-bit temp value in TMP275 format; see degCToRaw12()
+//
+
+uint8_t Systronix_TMP275::degFToRaw12 (uint16_t *raw12, float *tempF)
+	{
+	float		tempC = (*tempF - 32.0f) / 1.8f;
+
+	return degCToRaw12 (raw12, &tempC);
 	}
 
 
@@ -491,3 +1135,216 @@ uint8_t Systronix_TMP275::setShutdown (boolean sd)
 	return FAIL;
 	}
 
+
+//===========================< M U L T I - B U S   P O L L E R >==============================================
+
+
+//---------------------------< D E F A U L T   C O N S R U C T O R >------------------------------------------
+//
+// no buses yet
+//
+
+Systronix_TMP275_poller::Systronix_TMP275_poller (void)
+	{
+	_bus_count = 0;
+	_head = 0;
+	_tail = 0;
+	}
+
+
+//---------------------------< B U S _ A D D >----------------------------------------------------------------
+/**
+Add the sensors on one Wire net.  All sensors passed must share one net, and each net should be added only
+once or transfers will collide.  Sensors should already be set up and init()ed.
+
+returns SUCCESS, or FAIL if there are already TMP275_POLLER_BUSES buses or too many sensors
+**/
+
+uint8_t Systronix_TMP275_poller::bus_add (Systronix_TMP275* sensors[], uint8_t count)
+	{
+	bus_t*		bus;
+
+	if ((TMP275_POLLER_BUSES <= _bus_count) || (TMP275_POLLER_SENSORS < count))
+		return FAIL;
+
+	bus = &_bus[_bus_count];
+	for (uint8_t i = 0; i < count; i++)
+		bus->sensors[i] = sensors[i];
+	bus->count = count;
+	bus->index = 0;
+	bus->in_flight = false;
+	bus->sweep_active = false;
+	bus->sweep_start_us = 0;
+	bus_stats[_bus_count] = bus_stats_t();
+
+	_bus_count++;
+	return SUCCESS;
+	}
+
+
+//---------------------------< P O L L >----------------------------------------------------------------------
+/**
+Advance every bus: collect a finished transfer and start the next due sensor's read, so that each bus has
+a transfer in flight whenever some sensor on it may have a new conversion.  Never waits on the bus: a
+sensor whose pointer register must first be set gets that write in the background too (see
+Systronix_TMP275::get_temperature_data_start()).  Call as often as possible from loop().
+
+A sensor is read only when that read is certain to return a new conversion (see
+Systronix_TMP275::conversion_due()) and only new conversions are queued; a read that returns the same
+conversion again (possible only if the sensor was also read outside the poller) is counted in bus_stats
+repeats.
+
+Each bus works through its sensors in order; a pass through them all in which at least one read was started
+is a sweep.  Because the buses run independently, the sample rate grows with the number of buses until
+every sensor is read once per max conversion time.
+
+returns the number of samples added to the queue by this call
+**/
+
+uint8_t Systronix_TMP275_poller::poll (void)
+	{
+	uint8_t		completed = 0;
+
+	for (uint8_t b = 0; b < _bus_count; b++)
+		{
+		bus_t*		bus = &_bus[b];
+
+		if (0 == bus->count)
+			continue;
+
+		if (bus->in_flight)
+			{
+			Systronix_TMP275* sensor = bus->sensors[bus->index];
+
+			if (!sensor->get_temperature_data_done ())
+				continue;								// still busy; try the next bus
+
+			bus->in_flight = false;
+			if (SUCCESS != sensor->get_temperature_data_finish ())
+				{
+				if (UINT32_MAX > bus_stats[b].errors)
+					bus_stats[b].errors++;
+				}
+			else if (!sensor->data.fresh)				// same conversion as last time; don't queue it
+				{
+				if (UINT32_MAX > bus_stats[b].repeats)
+					bus_stats[b].repeats++;
+				}
+			else
+				{
+				sample_put (b, sensor);
+				completed++;
+				if (UINT32_MAX > bus_stats[b].samples)
+					bus_stats[b].samples++;
+				}
+
+			bus_advance (b);
+			}
+
+		for (uint8_t i = 0; i < bus->count; i++)		// start the next sensor that exists and is due
+			{
+			Systronix_TMP275* sensor = bus->sensors[bus->index];
+			uint8_t ret_val;
+
+			if (!sensor->conversion_due ())
+				{
+				bus_advance (b);						// no new conversion yet; don't spend the bus on it
+				continue;
+				}
+
+			ret_val = sensor->get_temperature_data_start ();
+			if (SUCCESS == ret_val)
+				{
+				if (!bus->sweep_active)
+					{
+					bus->sweep_active = true;
+					bus->sweep_start_us = micros();
+					}
+				bus->in_flight = true;
+				break;
+				}
+
+			if ((FAIL == ret_val) && (UINT32_MAX > bus_stats[b].errors))
+				bus_stats[b].errors++;				// absent sensors are skipped, not errors
+			bus_advance (b);
+			}
+		}
+
+	return completed;
+	}
+
+
+//---------------------------< S A M P L E _ G E T >----------------------------------------------------------
+//
+// Remove the oldest sample from the queue; returns true if there was one
+//
+
+boolean Systronix_TMP275_poller::sample_get (sample_t *sample)
+	{
+	if (_head == _tail)
+		return false;
+
+	*sample = _samples[_tail];
+	_tail = (_tail + 1) % TMP275_POLLER_SAMPLES;
+	return true;
+	}
+
+
+//---------------------------< B U S _ C O U N T _ G E T >----------------------------------------------------
+
+uint8_t Systronix_TMP275_poller::bus_count_get (void)
+	{
+	return _bus_count;
+	}
+
+
+//---------------------------< B U S _ A D V A N C E >--------------------------------------------------------
+//
+// move a bus on to its next sensor; wrapping to the first sensor completes a sweep, but only counts as one
+// if a read was started during it
+//
+
+void Systronix_TMP275_poller::bus_advance (uint8_t b)
+	{
+	bus_t*		bus = &_bus[b];
+
+	bus->index++;
+	if (bus->count > bus->index)
+		return;
+
+	bus->index = 0;
+	if (!bus->sweep_active)
+		return;
+
+	bus->sweep_active = false;
+	bus_stats[b].sweep_us = micros() - bus->sweep_start_us;
+	if (UINT32_MAX > bus_stats[b].sweeps)
+		bus_stats[b].sweeps++;
+	}
+
+
+//---------------------------< S A M P L E _ P U T >----------------------------------------------------------
+//
+// Add a sample to the queue.  If the queue is full the new sample is dropped and counted.
+//
+
+void Systronix_TMP275_poller::sample_put (uint8_t b, Systronix_TMP275* sensor)
+	{
+	uint8_t		next = (_head + 1) % TMP275_POLLER_SAMPLES;
+	sample_t*	sample;
+
+	if (next == _tail)
+		{
+		if (UINT32_MAX > samples_dropped)
+			samples_dropped++;
+		return;
+		}
+
+	sample = &_samples[_head];
+	sample->bus = b;
+	sample->base = sensor->base_get ();
+	sample->raw_temp = sensor->data.raw_temp;
+	sample->sequence = sensor->data.sequence;
+	sample->capture_ms = sensor->data.capture_ms;
+	_head = next;
+	}
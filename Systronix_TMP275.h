@@ -86,6 +86,23 @@ If A[2..0] are high, base is 0x4F, the max
 #define		TMP275_BASE_MIN			TMP275_SLAVE_ADDR_0
 #define		TMP275_BASE_MAX			TMP275_SLAVE_ADDR_7
 
+/** --------  General Call --------
+The TMP275 acknowledges the I2C general call address (0x00 with R/W = 0).  If the second byte is 0x06
+the part resets its internal registers to power-up values.  Every device on the bus that supports general
+call sees this, not just TMP275s.
+-------------------------------------*/
+#define		TMP275_GENERAL_CALL_ADDR	0x00
+#define		TMP275_GENERAL_CALL_RESET	0x06
+
+
+/** --------  Non-blocking read steps --------
+Where a get_temperature_data_start() read is: setting the pointer to the temperature register, reading the
+two temperature bytes, or stopped by a failed pointer write.
+-------------------------------------*/
+#define		TMP275_START_POINTER		1
+#define		TMP275_START_READ			2
+#define		TMP275_START_FAILED			3
+
 
 /** --------  Register Addresses --------
 The two lsb of the pointer register hold the register bits, which
@@ -124,6 +141,7 @@ for example TMP275_CFG_AL = 'AL', the Alert config bit
   Note that bit 7 (OS) always reads as zero!
 */
 #define		TMP275_CFG_POR_RD		0x0C90		// always reads as 0x00 after POR
+#define		TMP275_CFG_POR			0x00		// config register value after POR or general call reset
 
 /* One-shot/Conversion Ready is Config bit 7
   When in shutdown mode (SD=1), setting OS starts a single conversion
@@ -142,7 +160,23 @@ for example TMP275_CFG_AL = 'AL', the Alert config bit
 // I don't see a use for anything less than 12 bit mode
 
 #define		TMP275_CFG_RES12		0x60
+#define		TMP275_CFG_RES11		0x40
+#define		TMP275_CFG_RES10		0x20
 #define		TMP275_CFG_RES9			0x00		// both bits zero, 9-bit mode
+#define		TMP275_CFG_RES_MASK		0x60
+
+// Typical and max conversion time for each resolution, in msec (data sheet table 7; 9-bit 27.5 and
+// 37.5 ms rounded up). In continuous conversion mode a new temperature is available in the temp register
+// once per conversion time, so reading faster than this just returns the same value again.
+#define		TMP275_CONV_MS_RES9		28
+#define		TMP275_CONV_MS_RES10	55
+#define		TMP275_CONV_MS_RES11	110
+#define		TMP275_CONV_MS_RES12	220
+
+#define		TMP275_CONV_MAX_MS_RES9		38
+#define		TMP275_CONV_MAX_MS_RES10	75
+#define		TMP275_CONV_MAX_MS_RES11	150
+#define		TMP275_CONV_MAX_MS_RES12	300
 
 // Fault Queue Config bits 4,3
 // how many faults generate an Alert based on T-high and T-low registers
@@ -170,15 +204,39 @@ conversion value.
 
 #define		TMP275_CFG_SD			0x01		// 0 = continuous conversion state *default*
 
+/** --------  Threshold events --------
+Each instance can watch up to TMP275_THRESHOLDS setpoints.  Setpoints and hysteresis are converted to raw12
+codes once, when set, so each new sample is checked with integer compares only.  Crossings are queued as
+threshold_event_t; the queue holds one less than TMP275_EVENTS.
+-------------------------------------*/
+#define		TMP275_THRESHOLDS		4
+#define		TMP275_EVENTS			8
+
+#define		TMP275_RAW12_MIN		((int16_t)0xC900)	// -55 C, device minimum
+#define		TMP275_RAW12_MAX		((int16_t)0x7FF0)	// 127.9375 C, max 12-bit value
+#define		TMP275_HYSTERESIS_MAX_C	183.0f				// device range, rounded up
+
 class Systronix_TMP275
 {
 	protected:
 		uint8_t		_base;							// base address for this instance; four possible values
 		uint8_t		_pointer_reg;					// copy of the pointer register value so we know where it's pointing
 		uint8_t		_config_reg;					// copy
+
+		uint16_t	_conversion_raw;				// raw_temp of the most recent new conversion
+		uint32_t	_conversion_ms;					// millis() of the read that first returned it
+		boolean		_conversion_valid;				// false until the first read after construction or a device reset
+		boolean		config_matches (uint8_t config);	// compare a config read with _config_reg
+		void		shadow_reset (void);			// after a device reset
+		uint8_t		general_call_reset (void);		// reset every general call device on this bus; see fleet_init()
 		void		tally_transaction (uint8_t);	// maintains the i2c_t3 error counters
 		boolean		_base_clipped;
 
+		void		bus_tally (uint8_t byte_count);	// maintains stats bus counters
+		void		temperature_data_update (void);	// fill data from a new raw_temp
+		void		temperature_request (void);		// begin the non-blocking two byte read
+		uint8_t		_start_step;					// TMP275_START_xxx step of the non-blocking read
+
 		char* 		_wire_name = (char*)"empty";
 		i2c_t3		_wire = Wire;					// why is this assigned value = Wire? [bab]
 
@@ -190,6 +248,9 @@ class Systronix_TMP275
 		Errors peg at max value for the data type: they don't roll over.
 
 		Maybe different structs for data values and part control
+
+		data is written field-by-field by get_temperature_data() so it should only be read from the context
+		that calls get_...().  Other contexts should use data_snapshot_get() to get a consistent copy.
 		**/
 		struct data_t
 			{
@@ -198,9 +259,67 @@ class Systronix_TMP275
 			uint16_t	t_low = 0x07FF<<4; 		// historical low temp (preset here to device max high (128 C) raw12 format)
 			float		deg_c;        
 			float		deg_f;
-			bool		fresh;					// data is good and fresh TODO: how does one know that the data are not 'fresh'?
+			bool		fresh;					// true when the most recent get_...() call returned a new conversion
+			uint32_t	sequence = 0;			// incremented with each new conversion; 0 = no sample yet
+			uint32_t	capture_ms = 0;			// millis() of the read that first returned this conversion
 			} data;
 
+	protected:
+		/** Published copies of data for readers in other contexts (ISRs, other tasks).
+		This is a seqlock 'latch': while _snapshot_seq is odd readers use _snapshot[1] while _snapshot[0]
+		is rewritten, while even readers use _snapshot[0] while _snapshot[1] is rewritten.  Readers never wait
+		on the writer, which matters when an ISR interrupts get_temperature_data() on a single core.
+		**/
+		data_t		_snapshot[2];
+		volatile uint32_t	_snapshot_seq = 0;
+		void		snapshot_publish (void);
+
+	public:
+		struct threshold_event_t				// one setpoint crossing
+			{
+			uint8_t		threshold;				// index given to threshold_set()
+			boolean		rising;					// true: rose to or above setpoint; false: fell below setpoint - hysteresis
+			uint16_t	raw_temp;				// sample that crossed
+			uint32_t	sequence;				// data.sequence of that sample
+			};
+
+	protected:
+		struct threshold_t
+			{
+			int16_t		set;					// raw12 setpoint; rising crossing at raw >= set
+			int16_t		clear;					// raw12 setpoint - hysteresis; falling crossing at raw < clear
+			boolean		active = false;
+			boolean		above = false;
+			} _threshold[TMP275_THRESHOLDS];
+
+		// no threshold can be crossed while _threshold_low <= raw < _threshold_high
+		int16_t		_threshold_low = INT16_MIN;
+		int16_t		_threshold_high = INT16_MAX;
+
+		threshold_event_t	_events[TMP275_EVENTS];
+		volatile uint8_t	_event_head = 0;	// next slot to fill
+		volatile uint8_t	_event_tail = 0;	// oldest event
+
+		void		threshold_check (void);
+		void		threshold_window_update (void);
+
+	public:
+		/** Read statistics
+		reads_performed counts temperature reads attempted on the device, successful or not; reads_skipped
+		counts get_new_temperature_data() calls that returned the cached sample without a bus read.
+		bus_transactions and bus_bytes count every transfer attempted on the bus
+		by this instance; bytes include the address byte.  Like the error counters these peg at max; they
+		don't roll over.
+		**/
+		struct stats_t
+			{
+			uint32_t	reads_performed = 0;
+			uint32_t	reads_skipped = 0;
+			uint32_t	bus_transactions = 0;
+			uint32_t	bus_bytes = 0;
+			uint32_t	events_dropped = 0;		// threshold events lost because the queue was full
+			} stats;
+
 		/**
 		Array of Wire.status() extended return code strings, 11 as of 29Dec16 i2c_t3 release
 		index into this with the value of status.
@@ -269,12 +388,29 @@ class Systronix_TMP275
 		void 		begin (i2c_pins pins, i2c_rate rate);
 		void		begin (void);										// default begin
 		uint8_t		init (uint8_t control_value);						// set operation mode, check device present and communicating
+		uint8_t		config_verify (void);								// read config register and compare to shadow copy
+		static uint8_t	fleet_init (Systronix_TMP275* sensors[], uint8_t count, uint8_t config);	// reset and configure all sensors on one bus
 
 		float		raw12_to_c (uint16_t raw12);						// temperature conversion functions
 		float		raw12_to_f (uint16_t raw12);
 		uint8_t		get_temperature_data (void);
 		uint8_t		get_data ()											// an alias that may be useful
 						{return get_temperature_data ();};
+		uint8_t		get_new_temperature_data (void);					// reads only when a new conversion is certain
+		boolean		conversion_due (void);								// true if get_new_temperature_data() would read
+		uint16_t	conversion_period_get (void);						// typical msec per conversion at the configured resolution
+		uint16_t	conversion_period_max_get (void);					// max msec per conversion at the configured resolution
+		uint8_t		get_temperature_data_start (void);					// non-blocking read, see Systronix_TMP275_poller
+		boolean		get_temperature_data_done (void);
+		uint8_t		get_temperature_data_finish (void);
+
+		uint8_t		threshold_set (uint8_t index, float setpoint_c, float hysteresis_c);	// watch for crossings of setpoint_c
+		uint8_t		threshold_clear (uint8_t index);					// stop watching
+		boolean		threshold_event_get (threshold_event_t *event);		// oldest event from the queue
+
+		uint8_t		degCToRaw12 (uint16_t *raw12, float *tempC);		// use to store value in comparison registers
+		uint8_t		degFToRaw12 (uint16_t *raw12, float *tempF);
+		uint8_t		data_snapshot_get (data_t *snapshot);				// tear-free copy of data; safe from ISRs and other tasks
 
 		uint8_t		pointer_write (uint8_t pointer);					// i2c bus dependent functions
 		uint8_t		register16_write (uint8_t pointer, uint16_t data);	// write to 16-bit registers
@@ -288,8 +424,6 @@ class Systronix_TMP275
 //----- THESE FUNCTIONS not yet implemented; all return FAIL
 		uint8_t		tempReadDegC (float *tempC);
 		uint8_t		tempReadDegF (float *tempF);
-		uint8_t		degCToRaw12 (uint16_t *raw13, float *tempC);		// use to store value in comparison registers
-		uint8_t		degFToRaw12 (uint16_t *raw13, float *tempC);
 		uint8_t		getOneShotDegC (float *tempC);						// TODO may not be best approach for TMP275
 		uint8_t		setShutdown (boolean sd);							// ditto
 
@@ -297,6 +431,68 @@ class Systronix_TMP275
 
 };
 
+
+/** --------  Multi-bus poller --------
+Keeps a temperature read in flight on each of up to four Wire nets (Teensy 3.5 Wire..Wire2, 3.6 Wire..Wire3)
+at once and merges new conversions into one queue of samples.  Call poll() as often as possible from loop() and drain the
+queue with sample_get(); both must be called from the same context.
+-------------------------------------*/
+
+#define		TMP275_POLLER_BUSES		4			// Wire, Wire1, Wire2, Wire3
+#define		TMP275_POLLER_SENSORS	8			// one for each slave address
+#define		TMP275_POLLER_SAMPLES	32			// queue size; holds one less than this
+
+class Systronix_TMP275_poller
+{
+	public:
+		struct sample_t							// one temperature sample from any bus
+			{
+			uint8_t		bus;					// index in order of bus_add() calls
+			uint8_t		base;					// sensor slave address
+			uint16_t	raw_temp;
+			uint32_t	sequence;				// sensor's data.sequence for this sample
+			uint32_t	capture_ms;
+			};
+
+		struct bus_stats_t						// per-bus statistics; counters peg at max
+			{
+			uint32_t	samples = 0;			// new conversions queued
+			uint32_t	repeats = 0;			// good reads that returned the same conversion again; not queued
+			uint32_t	errors = 0;				// failed reads
+			uint32_t	sweeps = 0;				// passes through all of the bus's sensors with at least one read
+			uint32_t	sweep_us = 0;			// duration of the most recent sweep
+			} bus_stats[TMP275_POLLER_BUSES];
+
+		uint32_t	samples_dropped = 0;		// samples lost because the queue was full
+
+	protected:
+		struct bus_t
+			{
+			Systronix_TMP275*	sensors[TMP275_POLLER_SENSORS];
+			uint8_t		count;
+			uint8_t		index;					// sensor being read, or to be read next
+			boolean		in_flight;				// a read is in progress on this bus
+			boolean		sweep_active;			// a read has been started in the current sweep
+			uint32_t	sweep_start_us;
+			} _bus[TMP275_POLLER_BUSES];
+		uint8_t		_bus_count;
+
+		sample_t	_samples[TMP275_POLLER_SAMPLES];
+		uint8_t		_head;						// next slot to fill
+		uint8_t		_tail;						// oldest sample
+
+		void		bus_advance (uint8_t b);
+		void		sample_put (uint8_t b, Systronix_TMP275* sensor);
+
+	public:
+		Systronix_TMP275_poller (void);			// default constructor
+
+		uint8_t		bus_add (Systronix_TMP275* sensors[], uint8_t count);	// add the sensors on one Wire net
+		uint8_t		poll (void);											// advance all buses; never waits
+		boolean		sample_get (sample_t *sample);							// oldest sample from the queue
+		uint8_t		bus_count_get (void);
+};
+
 extern Systronix_TMP275 tmp275;
 
 #endif /* SYSTRONIX_TMP275_h */
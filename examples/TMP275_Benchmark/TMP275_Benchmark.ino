@@ -0,0 +1,270 @@
+/** ---------- TMP275 Library Benchmark ------------------------
+
+Copyright 2017 Systronix Inc www.systronix.com
+
+Measures the cost of the library's temperature conversion functions, of checking samples against setpoints
+as floats vs as raw12 codes (see threshold_set()), the number of I2C transactions and bytes each bus
+function generates, and the latency of a full sweep of every TMP275 found on Wire.
+
+Results are printed once, one JSON object per line, so that runs against different library versions
+can be saved and diffed to catch performance regressions:
+
+  {"bench":"raw12_to_c","calls":1000,"unit":"cycles","total":...,"per_call":...}
+
+On Teensy 3.x time is measured in CPU cycles with the DWT cycle counter; elsewhere in micros().
+Bus functions also report transactions and bytes per call from the library's stats counters.
+
+**/
+ 
+/** ---------- REVISIONS ----------
+
+2017Aug01 bboyes  Start
+--------------------------------**/
+
+#include <Arduino.h>
+#include <Systronix_TMP275.h>	// best version of I2C library is #included by the library. Don't include it here!
+
+#if defined ARM_DWT_CYCCNT
+  #define BENCH_UNIT    "cycles"
+  #define BENCH_NOW()   (ARM_DWT_CYCCNT)
+#else
+  #define BENCH_UNIT    "us"
+  #define BENCH_NOW()   (micros())
+#endif
+
+#define CONV_CALLS      1000      // conversion function calls per benchmark
+#define BUS_CALLS       100       // bus function calls per benchmark
+#define SWEEPS          20        // full sweeps of all sensors
+
+Systronix_TMP275 tmp275_sensors[8];       // one for each possible address
+uint8_t sensor_count = 0;         // how many of those answered
+
+volatile float sink;              // keeps the compiler from discarding conversion results
+
+
+//---------------------------< R E P O R T >------------------------------------------------------------------
+//
+// print one result line; transactions and bytes are only printed for bus benchmarks
+//
+
+void report (const char* name, uint32_t calls, uint32_t total, boolean bus, uint32_t transactions, uint32_t bytes)
+{
+  Serial.printf ("{\"bench\":\"%s\",\"calls\":%u,\"unit\":\"%s\",\"total\":%u,\"per_call\":%.2f",
+    name, calls, BENCH_UNIT, total, (float)total / calls);
+  if (bus)
+    Serial.printf (",\"transactions_per_call\":%.2f,\"bytes_per_call\":%.2f", (float)transactions / calls, (float)bytes / calls);
+  Serial.printf ("}\r\n");
+}
+
+
+//---------------------------< B E N C H _ C O N V E R S I O N S >-------------------------------------------
+//
+// walk raw12 codes across the device range so that both positive and negative values are converted
+//
+
+void bench_conversions (void)
+{
+  uint32_t start, total;
+  uint16_t raw12;
+  Systronix_TMP275* sensor = &tmp275_sensors[0];
+
+  raw12 = 0xC900;                           // -55 C
+  start = BENCH_NOW();
+  for (uint32_t i = 0; i < CONV_CALLS; i++)
+  {
+    sink = sensor->raw12_to_c (raw12);
+    raw12 += 0x0130;
+  }
+  total = BENCH_NOW() - start;
+  report ("raw12_to_c", CONV_CALLS, total, false, 0, 0);
+
+  raw12 = 0xC900;
+  start = BENCH_NOW();
+  for (uint32_t i = 0; i < CONV_CALLS; i++)
+  {
+    sink = sensor->raw12_to_f (raw12);
+    raw12 += 0x0130;
+  }
+  total = BENCH_NOW() - start;
+  report ("raw12_to_f", CONV_CALLS, total, false, 0, 0);
+
+  float temp_c = -55.0;
+  uint16_t raw_out;
+  start = BENCH_NOW();
+  for (uint32_t i = 0; i < CONV_CALLS; i++)
+  {
+    sensor->degCToRaw12 (&raw_out, &temp_c);
+    sink = raw_out;
+    temp_c += 0.18;
+  }
+  total = BENCH_NOW() - start;
+  report ("degCToRaw12", CONV_CALLS, total, false, 0, 0);
+}
+
+
+//---------------------------< B E N C H _ S E T P O I N T S >-----------------------------------------------
+//
+// the two ways to check a sample against setpoints: convert to float and compare, or compare raw12 codes
+// computed once with degCToRaw12(), which is what threshold_set() does
+//
+
+#define SETPOINTS 4
+
+void bench_setpoints (void)
+{
+  Systronix_TMP275* sensor = &tmp275_sensors[0];
+  float setpoint_c[SETPOINTS] = {0.0, 30.0, 50.0, 85.0};
+  int16_t setpoint_raw[SETPOINTS];
+  uint32_t start, total;
+  uint32_t above;
+  uint16_t raw12;
+
+  for (uint8_t j = 0; j < SETPOINTS; j++)
+    sensor->degCToRaw12 ((uint16_t*)&setpoint_raw[j], &setpoint_c[j]);
+
+  raw12 = 0xC900;
+  above = 0;
+  start = BENCH_NOW();
+  for (uint32_t i = 0; i < CONV_CALLS; i++)
+  {
+    float temp_c = sensor->raw12_to_c (raw12);
+    for (uint8_t j = 0; j < SETPOINTS; j++)
+      if (temp_c >= setpoint_c[j])
+        above++;
+    raw12 += 0x0130;
+  }
+  total = BENCH_NOW() - start;
+  sink = above;
+  report ("setpoints_float", CONV_CALLS, total, false, 0, 0);
+
+  raw12 = 0xC900;
+  above = 0;
+  start = BENCH_NOW();
+  for (uint32_t i = 0; i < CONV_CALLS; i++)
+  {
+    for (uint8_t j = 0; j < SETPOINTS; j++)
+      if ((int16_t)raw12 >= setpoint_raw[j])
+        above++;
+    raw12 += 0x0130;
+  }
+  total = BENCH_NOW() - start;
+  sink = above;
+  report ("setpoints_raw12", CONV_CALLS, total, false, 0, 0);
+}
+
+
+//---------------------------< B E N C H _ B U S >-----------------------------------------------------------
+//
+// time BUS_CALLS calls of one bus function on the first sensor found and report the stats deltas
+//
+
+#define BENCH_BUS(name, call)                                                             \
+  {                                                                                       \
+  uint32_t transactions = sensor->stats.bus_transactions;                                 \
+  uint32_t bytes = sensor->stats.bus_bytes;                                               \
+  uint32_t start = BENCH_NOW();                                                           \
+  for (uint32_t i = 0; i < BUS_CALLS; i++)                                                \
+    call;                                                                                 \
+  uint32_t total = BENCH_NOW() - start;                                                   \
+  report (name, BUS_CALLS, total, true, sensor->stats.bus_transactions - transactions,    \
+    sensor->stats.bus_bytes - bytes);                                                     \
+  }
+
+void bench_bus (void)
+{
+  Systronix_TMP275* sensor = &tmp275_sensors[0];
+  uint8_t config;
+  uint16_t tlow = 0;
+
+  sensor->pointer_write (TMP275_TLOW_REG_PTR);    // get Tlow so it can be rewritten unchanged
+  sensor->register16_read (&tlow);
+
+  BENCH_BUS ("get_temperature_data", sensor->get_temperature_data ());
+  BENCH_BUS ("get_new_temperature_data", sensor->get_new_temperature_data ());
+  BENCH_BUS ("config_read", sensor->config_read (&config));
+  BENCH_BUS ("register16_write", sensor->register16_write (TMP275_TLOW_REG_PTR, tlow));
+  BENCH_BUS ("config_read+get_temperature_data", {sensor->config_read (&config); sensor->get_temperature_data ();});
+
+  sensor->pointer_write (TMP275_TEMP_REG_PTR);    // leave the pointer set to read temperature
+}
+
+
+//---------------------------< B E N C H _ S W E E P >-------------------------------------------------------
+//
+// one sweep is a get_temperature_data() of every sensor found
+//
+
+void bench_sweep (void)
+{
+  uint32_t transactions = 0;
+  uint32_t bytes = 0;
+  uint32_t start, total;
+
+  for (uint8_t i = 0; i < sensor_count; i++)
+  {
+    transactions -= tmp275_sensors[i].stats.bus_transactions;
+    bytes -= tmp275_sensors[i].stats.bus_bytes;
+  }
+
+  start = BENCH_NOW();
+  for (uint32_t sweep = 0; sweep < SWEEPS; sweep++)
+    for (uint8_t i = 0; i < sensor_count; i++)
+      tmp275_sensors[i].get_temperature_data ();
+  total = BENCH_NOW() - start;
+
+  for (uint8_t i = 0; i < sensor_count; i++)
+  {
+    transactions += tmp275_sensors[i].stats.bus_transactions;
+    bytes += tmp275_sensors[i].stats.bus_bytes;
+  }
+
+  Serial.printf ("{\"bench\":\"sweep\",\"sensors\":%u,", sensor_count);
+  Serial.printf ("\"calls\":%u,\"unit\":\"%s\",\"total\":%u,\"per_call\":%.2f,\"transactions_per_call\":%.2f,\"bytes_per_call\":%.2f}\r\n",
+    SWEEPS, BENCH_UNIT, total, (float)total / SWEEPS, (float)transactions / SWEEPS, (float)bytes / SWEEPS);
+}
+
+
+/* ========== SETUP ========== */
+void setup(void) 
+{
+  Serial.begin(115200);     // use max baud rate
+  // Teensy3 doesn't reset with Serial Monitor as do Teensy2/++2, or wait for Serial Monitor window
+  // Wait here for 10 seconds to see if we will use Serial Monitor, so output is not lost
+  while((!Serial) && (millis()<10000));    // wait until serial monitor is open or timeout, which seems to fall through
+
+#if defined ARM_DWT_CYCCNT
+  ARM_DEMCR |= ARM_DEMCR_TRCENA;          // enable the DWT cycle counter
+  ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+#endif
+
+  Serial.printf ("{\"build\":\"%s %s\",\"f_cpu\":%u}\r\n", __DATE__, __TIME__, F_CPU);
+
+  // find the sensors; an instance whose init() fails is reused for the next address
+  for (uint8_t base = TMP275_BASE_MIN; base <= TMP275_BASE_MAX; base++)
+  {
+    tmp275_sensors[sensor_count].setup (base, Wire, (char*)"Wire");
+    if (0 == sensor_count)
+      tmp275_sensors[0].begin (I2C_PINS_18_19, I2C_RATE_400);
+    if (SUCCESS == tmp275_sensors[sensor_count].init (TMP275_CFG_RES12))
+      sensor_count++;
+  }
+
+  bench_conversions ();
+  bench_setpoints ();
+
+  if (0 == sensor_count)
+  {
+    Serial.printf ("{\"error\":\"no sensors found\"}\r\n");
+    return;
+  }
+
+  delay (TMP275_CONV_MS_RES12 + 20);      // first conversion at the new resolution
+  bench_bus ();
+  bench_sweep ();
+}
+
+
+/* ========== LOOP ========== */
+void loop(void) 
+{
+}
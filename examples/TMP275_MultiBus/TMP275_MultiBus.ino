@@ -0,0 +1,106 @@
+/** ---------- TMP275 Multi-Bus Poller Example ------------------------
+
+Copyright 2017 Systronix Inc www.systronix.com
+
+Reads TMP275s on Wire, Wire1 and Wire2 (Teensy 3.5) or Wire..Wire3 (Teensy 3.6) at the same time with
+Systronix_TMP275_poller.  Each bus has a read in flight whenever one of its sensors may have a new
+conversion, so several buses sweep faster than one.  New conversions from every bus come out of one
+queue; once a second the per-bus statistics are printed.
+
+**/
+ 
+/** ---------- REVISIONS ----------
+
+2017Aug08 bboyes  Start
+--------------------------------**/
+
+#include <Arduino.h>
+#include <Systronix_TMP275.h>	// best version of I2C library is #included by the library. Don't include it here!
+
+#if !defined(__MK64FX512__) && !defined(__MK66FX1M0__)
+  #error "This example is for Teensy 3.5 or 3.6"
+#endif
+
+#if I2C_BUS_NUM >= 4    // Teensy 3.6
+  #define BUSES 4
+#else                   // Teensy 3.5
+  #define BUSES 3
+#endif
+
+#define SENSORS 2       // sensors per bus, at 0x48 and 0x49
+
+Systronix_TMP275 tmp275_bus[BUSES][SENSORS];
+Systronix_TMP275* sensors[SENSORS];
+
+Systronix_TMP275_poller poller;
+
+i2c_t3 wires[BUSES] = {Wire, Wire1, Wire2
+#if I2C_BUS_NUM >= 4
+  , Wire3
+#endif
+  };
+const char* wire_names[BUSES] = {"Wire", "Wire1", "Wire2"
+#if I2C_BUS_NUM >= 4
+  , "Wire3"
+#endif
+  };
+i2c_pins wire_pins[BUSES] = {I2C_PINS_18_19, I2C_PINS_37_38, I2C_PINS_3_4
+#if I2C_BUS_NUM >= 4
+  , I2C_PINS_56_57
+#endif
+  };
+
+uint32_t print_ms = 0;
+uint32_t sample_count = 0;
+
+/* ========== SETUP ========== */
+void setup(void) 
+{
+  Serial.begin(115200);     // use max baud rate
+  // Teensy3 doesn't reset with Serial Monitor as do Teensy2/++2, or wait for Serial Monitor window
+  // Wait here for 10 seconds to see if we will use Serial Monitor, so output is not lost
+  while((!Serial) && (millis()<10000));    // wait until serial monitor is open or timeout, which seems to fall through
+
+  Serial.printf("TMP275 Multi-Bus Poller Example\r\n");
+
+  for (uint8_t b = 0; b < BUSES; b++)
+  {
+    for (uint8_t i = 0; i < SENSORS; i++)
+    {
+      tmp275_bus[b][i].setup (TMP275_SLAVE_ADDR_0 + i, wires[b], (char*)wire_names[b]);
+      if (0 == i)
+        tmp275_bus[b][0].begin (wire_pins[b], I2C_RATE_400);
+      if (SUCCESS != tmp275_bus[b][i].init (TMP275_CFG_RES12))
+        Serial.printf(" %s 0x%.2X not found\r\n", wire_names[b], tmp275_bus[b][i].base_get());
+      sensors[i] = &tmp275_bus[b][i];
+    }
+    poller.bus_add (sensors, SENSORS);
+  }
+
+  Serial.println("Setup Complete!");
+}
+
+
+/* ========== LOOP ========== */
+void loop(void) 
+{
+  Systronix_TMP275_poller::sample_t sample;
+
+  poller.poll ();
+
+  while (poller.sample_get (&sample))
+  {
+    sample_count++;
+    // application code would use the sample here
+  }
+
+  if (1000 <= (millis() - print_ms))
+  {
+    print_ms = millis();
+    Serial.printf ("@%u samples:%u dropped:%u\r\n", print_ms / 1000, sample_count, poller.samples_dropped);
+    for (uint8_t b = 0; b < poller.bus_count_get(); b++)
+      Serial.printf (" %s samples:%u repeats:%u errors:%u sweeps:%u sweep:%u us\r\n", wire_names[b],
+        poller.bus_stats[b].samples, poller.bus_stats[b].repeats, poller.bus_stats[b].errors,
+        poller.bus_stats[b].sweeps, poller.bus_stats[b].sweep_us);
+  }
+}
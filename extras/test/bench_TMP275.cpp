@@ -0,0 +1,180 @@
+/** ---------- TMP275 Library Host Benchmark ------------------------
+
+Host counterpart of examples/TMP275_Benchmark: times the temperature conversion functions and the two ways
+of checking a sample against setpoints with std::chrono::steady_clock, and reports the I2C transactions and
+bytes each bus function generates against the stand-in bus in stubs/.  Build and run with make bench.
+
+Output is the same one JSON object per line as the sketch, with time in nanoseconds:
+
+  {"bench":"raw12_to_c","calls":1000000,"unit":"ns","total":...,"per_call":...}
+
+Host times say nothing about Teensy times but do show whether a change made a function cheaper or dearer;
+the bus counts are the same as on the target.
+
+**/
+
+#include <stdio.h>
+#include <chrono>
+
+#include <Systronix_TMP275.h>
+
+#define CONV_CALLS		1000000						// conversion function calls per benchmark
+#define BUS_CALLS		100							// bus function calls per benchmark
+#define SETPOINTS		4
+
+typedef std::chrono::steady_clock bench_clock;
+
+volatile float sink;								// keeps the compiler from discarding conversion results
+
+
+//---------------------------< R E P O R T >------------------------------------------------------------------
+//
+// print one result line; transactions and bytes are only printed for bus benchmarks
+//
+
+static void report (const char* name, uint32_t calls, bench_clock::time_point start, bool bus, uint32_t transactions, uint32_t bytes)
+	{
+	uint64_t total = std::chrono::duration_cast<std::chrono::nanoseconds>(bench_clock::now () - start).count ();
+
+	printf ("{\"bench\":\"%s\",\"calls\":%u,\"unit\":\"ns\",\"total\":%llu,\"per_call\":%.2f",
+		name, calls, (unsigned long long)total, (double)total / calls);
+	if (bus)
+		printf (",\"transactions_per_call\":%.2f,\"bytes_per_call\":%.2f", (double)transactions / calls, (double)bytes / calls);
+	printf ("}\n");
+	}
+
+
+//---------------------------< B E N C H _ C O N V E R S I O N S >-------------------------------------------
+//
+// walk raw12 codes across the device range so that both positive and negative values are converted
+//
+
+static void bench_conversions (Systronix_TMP275 &sensor)
+	{
+	bench_clock::time_point start;
+	uint16_t raw12;
+	uint16_t raw_out;
+	float temp_c;
+
+	raw12 = 0xC900;									// -55 C
+	start = bench_clock::now ();
+	for (uint32_t i = 0; i < CONV_CALLS; i++)
+		{
+		sink = sensor.raw12_to_c (raw12);
+		raw12 += 0x0130;
+		}
+	report ("raw12_to_c", CONV_CALLS, start, false, 0, 0);
+
+	raw12 = 0xC900;
+	start = bench_clock::now ();
+	for (uint32_t i = 0; i < CONV_CALLS; i++)
+		{
+		sink = sensor.raw12_to_f (raw12);
+		raw12 += 0x0130;
+		}
+	report ("raw12_to_f", CONV_CALLS, start, false, 0, 0);
+
+	temp_c = -55.0;
+	start = bench_clock::now ();
+	for (uint32_t i = 0; i < CONV_CALLS; i++)
+		{
+		sensor.degCToRaw12 (&raw_out, &temp_c);
+		sink = raw_out;
+		temp_c = (125.0 < temp_c) ? -55.0 : temp_c + 0.18;
+		}
+	report ("degCToRaw12", CONV_CALLS, start, false, 0, 0);
+	}
+
+
+//---------------------------< B E N C H _ S E T P O I N T S >-----------------------------------------------
+//
+// convert to float and compare, or compare raw12 codes computed once with degCToRaw12()
+//
+
+static void bench_setpoints (Systronix_TMP275 &sensor)
+	{
+	float setpoint_c[SETPOINTS] = {0.0, 30.0, 50.0, 85.0};
+	int16_t setpoint_raw[SETPOINTS];
+	bench_clock::time_point start;
+	uint32_t above;
+	uint16_t raw12;
+
+	for (uint8_t j = 0; j < SETPOINTS; j++)
+		sensor.degCToRaw12 ((uint16_t*)&setpoint_raw[j], &setpoint_c[j]);
+
+	raw12 = 0xC900;
+	above = 0;
+	start = bench_clock::now ();
+	for (uint32_t i = 0; i < CONV_CALLS; i++)
+		{
+		float temp_c = sensor.raw12_to_c (raw12);
+		for (uint8_t j = 0; j < SETPOINTS; j++)
+			if (temp_c >= setpoint_c[j])
+				above++;
+		raw12 += 0x0130;
+		}
+	sink = above;
+	report ("setpoints_float", CONV_CALLS, start, false, 0, 0);
+
+	raw12 = 0xC900;
+	above = 0;
+	start = bench_clock::now ();
+	for (uint32_t i = 0; i < CONV_CALLS; i++)
+		{
+		for (uint8_t j = 0; j < SETPOINTS; j++)
+			if ((int16_t)raw12 >= setpoint_raw[j])
+				above++;
+		raw12 += 0x0130;
+		}
+	sink = above;
+	report ("setpoints_raw12", CONV_CALLS, start, false, 0, 0);
+	}
+
+
+//---------------------------< B E N C H _ B U S >-----------------------------------------------------------
+//
+// time BUS_CALLS calls of one bus function against the stand-in bus and report the stats deltas
+//
+
+#define BENCH_BUS(name, call)																\
+	{																						\
+	uint32_t transactions = sensor.stats.bus_transactions;									\
+	uint32_t bytes = sensor.stats.bus_bytes;												\
+	bench_clock::time_point start = bench_clock::now ();									\
+	for (uint32_t i = 0; i < BUS_CALLS; i++)												\
+		call;																				\
+	report (name, BUS_CALLS, start, true, sensor.stats.bus_transactions - transactions,		\
+		sensor.stats.bus_bytes - bytes);													\
+	}
+
+static void bench_bus (Systronix_TMP275 &sensor)
+	{
+	uint8_t config;
+
+	BENCH_BUS ("get_temperature_data", sensor.get_temperature_data ());
+	BENCH_BUS ("get_new_temperature_data", sensor.get_new_temperature_data ());
+	BENCH_BUS ("config_read", sensor.config_read (&config));
+	BENCH_BUS ("register16_write", sensor.register16_write (TMP275_TLOW_REG_PTR, 0x4B00));
+	BENCH_BUS ("config_read+get_temperature_data", {sensor.config_read (&config); sensor.get_temperature_data ();});
+	}
+
+
+int main (void)
+	{
+	Systronix_TMP275 sensor;
+
+	stub_i2c.absent = 0xFF;
+	stub_i2c.raw_temp = 0x1900;
+	stub_millis = 1000;
+	sensor.setup (TMP275_SLAVE_ADDR_0, Wire, (char*)"Wire");
+	if (SUCCESS != sensor.init (TMP275_CFG_RES12))
+		{
+		printf ("init failed\n");
+		return 1;
+		}
+
+	bench_conversions (sensor);
+	bench_setpoints (sensor);
+	bench_bus (sensor);
+	return 0;
+	}
@@ -0,0 +1,19 @@
+/*
+ * Host stand-in for Arduino.h: just enough for Systronix_TMP275 to build and run off target.
+ */
+
+#ifndef ARDUINO_STUB_h
+#define ARDUINO_STUB_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef bool boolean;
+
+uint32_t	millis (void);						// test-controlled clock, see stubs.cpp
+uint32_t	micros (void);
+
+template <class T> T max (T a, T b) {return (a > b) ? a : b;}
+template <class T> T min (T a, T b) {return (a < b) ? a : b;}
+
+#endif /* ARDUINO_STUB_h */
@@ -0,0 +1,84 @@
+/*
+ * Host stand-in for Systronix_i2c_common.h and i2c_t3.  The i2c_t3 class here does no I/O; it hands back
+ * whatever the test has put in stub_i2c, NAKs everything while stub_i2c.nak is set and NAKs the address in
+ * stub_i2c.absent.
+ */
+
+#ifndef SYSTRONIX_I2C_COMMON_STUB_h
+#define SYSTRONIX_I2C_COMMON_STUB_h
+
+#include <cerrno>								// glibc typedefs error_t here; keep it out of the way
+#define		error_t		i2c_error_t
+
+#include <Arduino.h>
+
+#define		SUCCESS				0
+#define		ABSENT				0xFD
+#define		FAIL				0xFF
+
+#define		I2C_ADDR_NAK		5
+#define		WR_INCOMPLETE		11
+#define		SILLY_PROGRAMMER	12
+
+enum i2c_mode {I2C_MASTER, I2C_SLAVE};
+enum i2c_pins {I2C_PINS_18_19};
+enum i2c_pullup {I2C_PULLUP_EXT, I2C_PULLUP_INT};
+enum i2c_rate {I2C_RATE_100, I2C_RATE_400};
+enum i2c_stop {I2C_NOSTOP, I2C_STOP};
+
+struct i2c_error_t
+	{
+	boolean		exists;
+	uint8_t		error_val;
+	uint64_t	total_error_count;
+	uint64_t	successful_count;
+	};
+
+struct i2c_stub_t
+	{
+	uint16_t	raw_temp;						// returned by 2-byte reads
+	uint8_t		config;							// returned by 1-byte reads
+	boolean		nak;							// fail every transaction
+	uint8_t		absent;							// fail transactions to this address; 0xFF for none
+	uint8_t		address;						// address of the current transaction
+	uint32_t	blocking;						// endTransmission() and requestFrom() calls, which wait on the bus
+	uint8_t		rx[2];
+	uint8_t		rx_count;
+	uint8_t		rx_index;
+	};
+
+extern i2c_stub_t stub_i2c;
+extern uint32_t stub_millis;
+
+class i2c_t3
+	{
+	public:
+		void		begin (void) {}
+		void		begin (i2c_mode, uint8_t, i2c_pins, i2c_pullup, i2c_rate) {}
+		void		setDefaultTimeout (uint32_t) {}
+		void		beginTransmission (uint8_t address) {stub_i2c.address = address;}
+		size_t		write (uint8_t) {return 1;}
+		uint8_t		endTransmission (void) {stub_i2c.blocking++; return status ();}
+		void		sendTransmission (i2c_stop) {}
+		size_t		requestFrom (uint8_t address, size_t length, i2c_stop) {stub_i2c.blocking++; sendRequest (address, length, I2C_STOP); return available ();}
+		void		sendRequest (uint8_t, size_t length, i2c_stop);
+		uint8_t		done (void) {return 1;}
+		uint8_t		finish (void) {return 1;}
+		int			available (void) {return stub_i2c.rx_count - stub_i2c.rx_index;}
+		uint8_t		readByte (void) {return stub_i2c.rx[stub_i2c.rx_index++];}
+		uint8_t		status (void) {return (stub_i2c.nak || (stub_i2c.absent == stub_i2c.address)) ? I2C_ADDR_NAK : SUCCESS;}
+		void		resetBus (void) {}
+		uint32_t	resetBusCountRead (void) {return 0;}
+	};
+
+extern i2c_t3 Wire;
+
+class Systronix_i2c_common
+	{
+	public:
+		void		tally_transaction (uint8_t value, i2c_error_t *error);
+	};
+
+extern Systronix_i2c_common i2c_common;
+
+#endif /* SYSTRONIX_I2C_COMMON_STUB_h */
@@ -0,0 +1,48 @@
+/*
+ * Definitions for the host stand-ins in Arduino.h and Systronix_i2c_common.h
+ */
+
+#include <Systronix_i2c_common.h>
+
+i2c_stub_t stub_i2c;
+uint32_t stub_millis = 0;
+
+i2c_t3 Wire;
+Systronix_i2c_common i2c_common;
+
+uint32_t millis (void)
+	{
+	return stub_millis;
+	}
+
+uint32_t micros (void)
+	{
+	return stub_millis * 1000;
+	}
+
+void i2c_t3::sendRequest (uint8_t address, size_t length, i2c_stop)
+	{
+	stub_i2c.address = address;
+	stub_i2c.rx_index = 0;
+	stub_i2c.rx_count = 0;
+	if (SUCCESS != Wire.status ())
+		return;
+
+	if (2 == length)
+		{
+		stub_i2c.rx[0] = (uint8_t)(stub_i2c.raw_temp >> 8);
+		stub_i2c.rx[1] = (uint8_t)stub_i2c.raw_temp;
+		}
+	else
+		stub_i2c.rx[0] = stub_i2c.config;
+	stub_i2c.rx_count = (uint8_t)length;
+	}
+
+void Systronix_i2c_common::tally_transaction (uint8_t value, i2c_error_t *error)
+	{
+	error->error_val = value;
+	if (SUCCESS == value)
+		error->successful_count++;
+	else
+		error->total_error_count++;
+	}
@@ -0,0 +1,16 @@
+/*
+ * Forced into the library build by the Makefile so the tests can run code at points inside the snapshot
+ * latch, standing in for an interrupt that arrives there.
+ */
+
+#ifndef TMP275_TEST_HOOKS_h
+#define TMP275_TEST_HOOKS_h
+
+#include <stdint.h>
+
+class Systronix_TMP275;
+void		tmp275_snapshot_hook (Systronix_TMP275* sensor, uint8_t point);
+
+#define		TMP275_SNAPSHOT_HOOK(point)		tmp275_snapshot_hook (this, point)
+
+#endif /* TMP275_TEST_HOOKS_h */
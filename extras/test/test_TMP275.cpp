@@ -0,0 +1,693 @@
+/** ---------- TMP275 Library Host Tests ------------------------
+
+Runs the library off target against the stand-ins in stubs/.  Build and run with make.
+
+Snapshot latch: a writer and a reader hammer snapshot_publish() and data_snapshot_get(), first as two
+threads and then with one side in a fast timer signal as an ISR, and every copy is checked field by field
+against its sequence number; then the hooks in the latch are used to run a writer or a reader as if from
+an interrupt at each point where one could arrive.
+
+Thresholds: degCToRaw12() rounding and range, and crossings with hysteresis.
+
+Bus counts: transactions and bytes per bus function as counted in stats.
+
+Freshness: data.fresh and data.sequence follow new conversions and get_new_temperature_data() reads only
+when a new conversion is certain.
+
+**/
+
+#include <math.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/time.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <Systronix_TMP275.h>
+
+static int failures = 0;
+
+#define CHECK(cond) \
+	do { if (!(cond)) { printf ("FAIL %s:%d: %s\n", __FILE__, __LINE__, #cond); failures++; } } while (0)
+
+
+//---------------------------< T E S T   F I X T U R E S >----------------------------------------------------
+
+class Test_TMP275 : public Systronix_TMP275
+	{
+	public:
+		using Systronix_TMP275::_snapshot;
+		using Systronix_TMP275::_snapshot_seq;
+		using Systronix_TMP275::snapshot_publish;
+
+		uint8_t read (uint16_t raw)						// one get_temperature_data() returning raw
+			{
+			stub_i2c.raw_temp = raw;
+			return get_temperature_data ();
+			}
+
+		boolean consistent (const data_t &d)			// every field came from the same sample
+			{
+			return (d.deg_c == raw12_to_c (d.raw_temp)) && (d.deg_f == raw12_to_f (d.raw_temp));
+			}
+	};
+
+static void (*hook_fn) (Test_TMP275*, uint8_t) = NULL;
+
+void tmp275_snapshot_hook (Systronix_TMP275* sensor, uint8_t point)
+	{
+	if (hook_fn)
+		hook_fn (static_cast<Test_TMP275*>(sensor), point);
+	}
+
+static void sensor_start (Test_TMP275 &sensor)
+	{
+	stub_i2c = i2c_stub_t();
+	stub_i2c.absent = 0xFF;
+	stub_millis = 1000;
+	sensor.setup (TMP275_SLAVE_ADDR_0, Wire, (char*)"Wire");
+	CHECK (SUCCESS == sensor.init (TMP275_CFG_RES12));
+	}
+
+
+//---------------------------< S N A P S H O T   S T R E S S >------------------------------------------------
+//
+// Writer thread publishes back to back samples whose every field is a function of the sample's sequence
+// number; reader thread checks every copy against its own sequence, so a copy mixing two samples is caught
+// whichever fields it mixes.  The writer calls snapshot_publish() directly so that it spends most of its
+// time inside the latch; through the bus read path the race window is too rare to hit.
+//
+
+static void stress_sample (Test_TMP275 &sensor, Systronix_TMP275::data_t &d, uint32_t sequence)
+	{
+	d.raw_temp = (uint16_t)(((int16_t)(sequence % 2000) - 880) << 4);
+	d.t_high = d.raw_temp + 0x10;
+	d.t_low = d.raw_temp - 0x10;
+	d.deg_c = sensor.raw12_to_c (d.raw_temp);
+	d.deg_f = sensor.raw12_to_f (d.raw_temp);
+	d.fresh = (sequence & 1);
+	d.sequence = sequence;
+	d.capture_ms = 1000 + (sequence * 3);
+	}
+
+static boolean stress_matches (Test_TMP275 &sensor, const Systronix_TMP275::data_t &d)
+	{
+	Systronix_TMP275::data_t expected;
+
+	stress_sample (sensor, expected, d.sequence);
+	return (d.raw_temp == expected.raw_temp) && (d.t_high == expected.t_high) && (d.t_low == expected.t_low) &&
+		(d.deg_c == expected.deg_c) && (d.deg_f == expected.deg_f) && (d.fresh == expected.fresh) &&
+		(d.capture_ms == expected.capture_ms);
+	}
+
+static void test_snapshot_stress (void)
+	{
+	Test_TMP275 sensor;
+	std::atomic<bool> done (false);
+	uint32_t reads = 0;
+	uint32_t torn = 0;
+	uint32_t backwards = 0;
+
+	sensor_start (sensor);
+
+	std::thread writer ([&]
+		{
+		std::chrono::steady_clock::time_point stop = std::chrono::steady_clock::now () + std::chrono::seconds (1);
+		uint32_t sequence = 0;
+
+		do
+			{
+			for (uint16_t i = 0; i < 4096; i++)
+				{
+				stress_sample (sensor, sensor.data, ++sequence);
+				sensor.snapshot_publish ();
+				}
+			}
+		while (std::chrono::steady_clock::now () < stop);
+		done = true;
+		});
+
+	std::thread reader ([&]
+		{
+		Systronix_TMP275::data_t d;
+		uint32_t last_sequence = 0;
+
+		while (!done)
+			{
+			if (SUCCESS != sensor.data_snapshot_get (&d))
+				continue;
+			reads++;
+			if (!stress_matches (sensor, d))
+				torn++;
+			if (d.sequence < last_sequence)
+				backwards++;
+			last_sequence = d.sequence;
+			}
+		});
+
+	writer.join ();
+	reader.join ();
+
+	printf ("snapshot stress: %u reads, %u torn, %u out of order\n", reads, torn, backwards);
+	CHECK (0 < reads);
+	CHECK (0 == torn);
+	CHECK (0 == backwards);
+	}
+
+
+//---------------------------< S N A P S H O T   I N T E R R U P T   S T R E S S >----------------------------
+//
+// The same check with the other side in a signal handler fired every 20 usec, as an ISR would be on the
+// target: the timer lands on any instruction, including the middle of a slot copy, so this does not need
+// a second core to hit the race.  First the handler reads while the main line writes, then the other way
+// round.
+//
+
+static Test_TMP275* volatile stress_sensor;
+static volatile sig_atomic_t stress_isr_writes;
+static volatile uint32_t stress_isr_sequence;
+static volatile uint32_t stress_isr_reads;
+static volatile uint32_t stress_isr_torn;
+
+static void stress_isr (int)
+	{
+	Systronix_TMP275::data_t d;
+
+	if (stress_isr_writes)
+		{
+		stress_sample (*stress_sensor, stress_sensor->data, ++stress_isr_sequence);
+		stress_sensor->snapshot_publish ();
+		return;
+		}
+
+	if (SUCCESS != stress_sensor->data_snapshot_get (&d))
+		return;
+	stress_isr_reads++;
+	if (!stress_matches (*stress_sensor, d))
+		stress_isr_torn++;
+	}
+
+static void test_snapshot_interrupt_stress (void)
+	{
+	Test_TMP275 sensor;
+	Systronix_TMP275::data_t d;
+	struct itimerval timer = {{0, 20}, {0, 20}};
+	struct itimerval off = {{0, 0}, {0, 0}};
+	std::chrono::steady_clock::time_point stop;
+	uint32_t sequence = 0;
+	uint32_t reads = 0;
+	uint32_t torn = 0;
+
+	sensor_start (sensor);
+	stress_sensor = &sensor;
+	stress_isr_writes = false;
+	stress_isr_reads = 0;
+	stress_isr_torn = 0;
+	signal (SIGALRM, stress_isr);
+
+	setitimer (ITIMER_REAL, &timer, NULL);				// handler reads, main line writes
+	stop = std::chrono::steady_clock::now () + std::chrono::seconds (1);
+	do
+		{
+		for (uint16_t i = 0; i < 4096; i++)
+			{
+			stress_sample (sensor, sensor.data, ++sequence);
+			sensor.snapshot_publish ();
+			}
+		}
+	while (std::chrono::steady_clock::now () < stop);
+	setitimer (ITIMER_REAL, &off, NULL);
+
+	stress_isr_sequence = sequence;
+	stress_isr_writes = true;
+	setitimer (ITIMER_REAL, &timer, NULL);				// handler writes, main line reads
+	stop = std::chrono::steady_clock::now () + std::chrono::seconds (1);
+	do
+		{
+		for (uint16_t i = 0; i < 4096; i++)
+			{
+			if (SUCCESS != sensor.data_snapshot_get (&d))
+				continue;
+			reads++;
+			if (!stress_matches (sensor, d))
+				torn++;
+			}
+		}
+	while (std::chrono::steady_clock::now () < stop);
+	setitimer (ITIMER_REAL, &off, NULL);
+	signal (SIGALRM, SIG_DFL);
+
+	printf ("snapshot interrupt stress: %u isr reads, %u torn; %u reads under isr writes, %u torn\n",
+		(uint32_t)stress_isr_reads, (uint32_t)stress_isr_torn, reads, torn);
+	CHECK (0 < stress_isr_reads);
+	CHECK (0 == stress_isr_torn);
+	CHECK (stress_isr_sequence > sequence);				// the handler did publish
+	CHECK (0 == torn);
+	}
+
+
+//---------------------------< W R I T E R   I N   I S R >----------------------------------------------------
+//
+// A new sample is published after the reader has copied a slot but before it rechecks _snapshot_seq.  The
+// sequence moves on by two, so the reader must discard its copy and take the new sample.
+//
+
+static uint32_t copies;
+
+static void writer_isr (Test_TMP275* sensor, uint8_t point)
+	{
+	if (2 != point)
+		return;
+	if (1 == ++copies)
+		{
+		uint32_t seq = sensor->_snapshot_seq;
+		sensor->read (0x1900);							// 25 C
+		CHECK (seq + 2 == sensor->_snapshot_seq);
+		}
+	}
+
+static void test_snapshot_writer_isr (void)
+	{
+	Test_TMP275 sensor;
+	Systronix_TMP275::data_t d;
+
+	sensor_start (sensor);
+	sensor.read (0x0500);								// 5 C
+
+	copies = 0;
+	hook_fn = writer_isr;
+	CHECK (SUCCESS == sensor.data_snapshot_get (&d));
+	hook_fn = NULL;
+
+	CHECK (2 == copies);								// retried once
+	CHECK (0x1900 == d.raw_temp);
+	CHECK (2 == d.sequence);
+	CHECK (sensor.consistent (d));
+	}
+
+
+//---------------------------< R E A D E R   I N   I S R >----------------------------------------------------
+//
+// A reader interrupts the writer just before each slot is written.  The slot about to be written is
+// scribbled with a half-written sample; the reader must not copy it and must not have to retry (an ISR can't
+// wait for the writer it interrupted).
+//
+
+static uint32_t isr_sequence[2];
+
+static void reader_isr (Test_TMP275* sensor, uint8_t point)
+	{
+	Systronix_TMP275::data_t d;
+
+	if (2 == point)
+		{
+		copies++;
+		return;
+		}
+
+	sensor->_snapshot[point].raw_temp = 0x7FF0;			// half-written: new raw, old everything else
+
+	copies = 0;
+	CHECK (SUCCESS == sensor->data_snapshot_get (&d));
+	CHECK (1 == copies);
+	CHECK (sensor->consistent (d));
+	isr_sequence[point] = d.sequence;
+	}
+
+static void test_snapshot_reader_isr (void)
+	{
+	Test_TMP275 sensor;
+	Systronix_TMP275::data_t d;
+
+	sensor_start (sensor);
+	sensor.read (0x0500);
+
+	hook_fn = reader_isr;
+	sensor.read (0x1900);
+	hook_fn = NULL;
+
+	CHECK (1 == isr_sequence[0]);						// before slot 0 written: still the old sample
+	CHECK (2 == isr_sequence[1]);						// slot 0 done: the new sample
+	CHECK (SUCCESS == sensor.data_snapshot_get (&d));
+	CHECK ((0x1900 == d.raw_temp) && sensor.consistent (d));
+	}
+
+
+//---------------------------< F R E S H N E S S >------------------------------------------------------------
+//
+// fresh and sequence follow new conversions, not bus reads; get_new_temperature_data() reads only when a
+// new conversion is certain: one max conversion time (300 ms at 12 bits) after the last one was first read
+//
+
+static void test_freshness (void)
+	{
+	Test_TMP275 sensor;
+	uint32_t performed;
+
+	sensor_start (sensor);
+	CHECK (TMP275_CONV_MS_RES12 == sensor.conversion_period_get ());
+	CHECK (TMP275_CONV_MAX_MS_RES12 == sensor.conversion_period_max_get ());
+
+	stub_i2c.raw_temp = 0x1900;
+	CHECK (SUCCESS == sensor.get_new_temperature_data ());				// first read is always new
+	CHECK (sensor.data.fresh && (1 == sensor.data.sequence) && (1000 == sensor.data.capture_ms));
+
+	stub_millis = 1001;													// the immediate re-read is not due
+	CHECK (!sensor.conversion_due ());
+
+	stub_millis = 1220;													// past typical, short of max: no bus read
+	performed = sensor.stats.reads_performed;
+	CHECK (SUCCESS == sensor.get_new_temperature_data ());
+	CHECK (!sensor.data.fresh && (performed == sensor.stats.reads_performed) && (1 == sensor.stats.reads_skipped));
+
+	stub_millis = 1300;													// max time: same value is still new
+	CHECK (SUCCESS == sensor.get_new_temperature_data ());
+	CHECK (sensor.data.fresh && (2 == sensor.data.sequence) && (performed + 1 == sensor.stats.reads_performed));
+
+	stub_millis = 1599;													// same value before max time: repeat
+	CHECK (!sensor.conversion_due ());
+	CHECK (SUCCESS == sensor.get_temperature_data ());
+	CHECK (!sensor.data.fresh && (2 == sensor.data.sequence));
+
+	stub_millis = 1400;													// changed value is new at any time
+	stub_i2c.raw_temp = 0x1910;
+	CHECK (SUCCESS == sensor.get_temperature_data ());
+	CHECK (sensor.data.fresh && (3 == sensor.data.sequence) && (1400 == sensor.data.capture_ms));
+
+	stub_millis = 1699;													// hold-off runs from that read
+	CHECK (!sensor.conversion_due ());
+	stub_millis = 1700;
+	CHECK (sensor.conversion_due ());
+
+	performed = sensor.stats.reads_performed;							// failed reads are counted
+	stub_i2c.nak = true;
+	CHECK (FAIL == sensor.get_temperature_data ());
+	CHECK ((performed + 1 == sensor.stats.reads_performed) && !sensor.data.fresh);
+	}
+
+
+//---------------------------< S T E A D Y >------------------------------------------------------------------
+//
+// at a constant temperature every read get_new_temperature_data() makes must return a new conversion
+//
+
+static void test_steady (void)
+	{
+	Test_TMP275 sensor;
+	uint32_t sequence;
+	uint32_t performed;
+
+	sensor_start (sensor);
+	stub_i2c.raw_temp = 0x1900;
+	sequence = sensor.data.sequence;
+	performed = sensor.stats.reads_performed;
+
+	for (uint32_t ms = 0; ms < 10000; ms++)								// every 1 ms for 10 s
+		{
+		stub_millis = 1000 + ms;
+		CHECK (SUCCESS == sensor.get_new_temperature_data ());
+		}
+
+	CHECK ((sensor.stats.reads_performed - performed) == (sensor.data.sequence - sequence));
+	CHECK ((10000 / TMP275_CONV_MAX_MS_RES12) + 1 == sensor.stats.reads_performed - performed);
+	}
+
+
+//---------------------------< B U S   C O U N T S >----------------------------------------------------------
+//
+// stats.bus_transactions and stats.bus_bytes count what each bus function puts on the wire, address byte
+// included; a read of the temperature costs an extra pointer write unless the pointer is already there
+//
+
+static void bus_count (Test_TMP275 &sensor, uint32_t transactions, uint32_t bytes)
+	{
+	CHECK (transactions == sensor.stats.bus_transactions);
+	CHECK (bytes == sensor.stats.bus_bytes);
+	sensor.stats.bus_transactions = 0;
+	sensor.stats.bus_bytes = 0;
+	}
+
+static void test_bus_counts (void)
+	{
+	Test_TMP275 sensor;
+	uint8_t config;
+
+	sensor_start (sensor);								// init leaves the pointer on the config register
+	bus_count (sensor, sensor.stats.bus_transactions, sensor.stats.bus_bytes);
+
+	CHECK (SUCCESS == sensor.get_temperature_data ());	// pointer write + read
+	bus_count (sensor, 2, 5);
+	CHECK (SUCCESS == sensor.get_temperature_data ());	// pointer already on temperature
+	bus_count (sensor, 1, 3);
+
+	CHECK (SUCCESS == sensor.register16_write (TMP275_TLOW_REG_PTR, 0x1900));
+	bus_count (sensor, 1, 4);
+	CHECK (SUCCESS == sensor.get_temperature_data ());	// register16_write moved the pointer
+	bus_count (sensor, 2, 5);
+
+	CHECK (SUCCESS == sensor.config_read (&config));	// pointer write + read
+	bus_count (sensor, 2, 4);
+	CHECK (SUCCESS == sensor.config_write (TMP275_CFG_RES12));
+	bus_count (sensor, 1, 3);
+	}
+
+
+//---------------------------< F L E E T _ I N I T >----------------------------------------------------------
+//
+// a sensor that doesn't answer is marked absent even when config is the power-up value and nothing is
+// written; the reset forgets each sensor's conversion history but data.sequence keeps counting
+//
+
+static void test_fleet_init (void)
+	{
+	Test_TMP275 a;
+	Test_TMP275 b;
+	Systronix_TMP275* fleet[2] = {&a, &b};
+
+	sensor_start (a);
+	sensor_start (b);
+	b.setup (TMP275_SLAVE_ADDR_1, Wire, (char*)"Wire");
+	CHECK (SUCCESS == b.init (TMP275_CFG_RES12));
+	a.read (0x1900);
+	b.read (0x1900);
+
+	stub_i2c.absent = TMP275_SLAVE_ADDR_1;
+	stub_i2c.config = TMP275_CFG_POR;
+	CHECK (FAIL == Systronix_TMP275::fleet_init (fleet, 2, TMP275_CFG_POR));
+	CHECK (a.exists () && !b.exists ());
+	CHECK ((1 == a.data.sequence) && a.conversion_due ());
+	CHECK (TMP275_CONV_MS_RES9 == a.conversion_period_get ());
+	CHECK ((SUCCESS == a.read (0x1900)) && a.data.fresh && (2 == a.data.sequence));	// same value, but new
+
+	stub_i2c.absent = 0xFF;
+	stub_i2c.config = TMP275_CFG_RES12;
+	CHECK (SUCCESS == Systronix_TMP275::fleet_init (fleet, 2, TMP275_CFG_RES12));
+	CHECK (a.exists () && b.exists ());
+
+	stub_i2c.config = TMP275_CFG_RES9;									// answers, but wrong value
+	CHECK (FAIL == Systronix_TMP275::fleet_init (fleet, 2, TMP275_CFG_RES12));
+	CHECK (a.exists () && b.exists ());
+	}
+
+
+//---------------------------< P O L L E R >------------------------------------------------------------------
+//
+// the poller reads each sensor only when a new conversion is certain, queues only new conversions, never
+// waits on the bus, and a bus whose sensors are all absent never counts a sweep
+//
+
+static void test_poller (void)
+	{
+	Test_TMP275 a;
+	Test_TMP275 b;
+	Test_TMP275 gone;
+	Systronix_TMP275* bus0[2] = {&a, &b};
+	Systronix_TMP275* bus1[1] = {&gone};
+	Systronix_TMP275_poller poller;
+	Systronix_TMP275_poller::sample_t sample;
+	uint32_t queued = 0;
+	uint32_t blocking;
+	uint32_t transactions;
+	uint32_t bytes;
+	uint8_t config;
+
+	sensor_start (a);
+	sensor_start (b);
+	b.setup (TMP275_SLAVE_ADDR_1, Wire, (char*)"Wire");
+	CHECK (SUCCESS == b.init (TMP275_CFG_RES12));
+	gone.setup (TMP275_SLAVE_ADDR_2, Wire, (char*)"Wire");
+	stub_i2c.absent = TMP275_SLAVE_ADDR_2;
+	CHECK (ABSENT == gone.init (TMP275_CFG_RES12));
+	transactions = a.stats.bus_transactions;			// init left the pointer on the config register
+	bytes = a.stats.bus_bytes;
+
+	CHECK (SUCCESS == poller.bus_add (bus0, 2));
+	CHECK (SUCCESS == poller.bus_add (bus1, 1));
+	blocking = stub_i2c.blocking;
+
+	stub_i2c.raw_temp = 0x1900;
+	for (uint16_t i = 0; i < 100; i++)					// same instant: each sensor read once
+		poller.poll ();
+	while (poller.sample_get (&sample))
+		queued++;
+	CHECK (2 == queued);
+	CHECK ((2 == a.stats.bus_transactions - transactions) && (5 == a.stats.bus_bytes - bytes));	// pointer write + read
+	CHECK ((2 == poller.bus_stats[0].samples) && (1 == poller.bus_stats[0].sweeps));
+	CHECK ((1 == a.stats.reads_performed) && (1 == b.stats.reads_performed));
+	CHECK ((0 == poller.bus_stats[1].sweeps) && (0 == poller.bus_stats[1].errors));
+
+	stub_millis += TMP275_CONV_MS_RES12;				// typical time: not due yet, no reads
+	for (uint16_t i = 0; i < 100; i++)
+		poller.poll ();
+	CHECK (!poller.sample_get (&sample));
+	CHECK ((1 == a.stats.reads_performed) && (1 == poller.bus_stats[0].sweeps));
+
+	stub_millis += TMP275_CONV_MAX_MS_RES12 - TMP275_CONV_MS_RES12;	// max time: same value is a new conversion
+	for (uint16_t i = 0; i < 100; i++)
+		poller.poll ();
+	CHECK (poller.sample_get (&sample) && (2 == sample.sequence));
+	CHECK (poller.sample_get (&sample) && !poller.sample_get (&sample));
+	CHECK ((0 == poller.bus_stats[0].repeats) && (2 == poller.bus_stats[0].sweeps));
+
+	stub_millis += TMP275_CONV_MAX_MS_RES12;			// new value on both
+	stub_i2c.raw_temp = 0x1910;
+	for (uint16_t i = 0; i < 100; i++)
+		poller.poll ();
+	CHECK (poller.sample_get (&sample));
+	CHECK ((0 == sample.bus) && (TMP275_SLAVE_ADDR_0 == sample.base) && (0x1910 == sample.raw_temp) && (3 == sample.sequence));
+	CHECK (poller.sample_get (&sample));
+	CHECK (TMP275_SLAVE_ADDR_1 == sample.base);
+	CHECK (!poller.sample_get (&sample));
+	CHECK ((6 == poller.bus_stats[0].samples) && (0 == poller.bus_stats[1].sweeps));
+	CHECK (blocking == stub_i2c.blocking);				// poll() never waited on the bus
+
+	a.config_read (&config);							// moves the pointer; a failed pointer write is an error
+	stub_millis += TMP275_CONV_MAX_MS_RES12;
+	stub_i2c.nak = true;
+	for (uint16_t i = 0; i < 100; i++)
+		poller.poll ();
+	CHECK ((2 <= poller.bus_stats[0].errors) && (6 == poller.bus_stats[0].samples));
+	}
+
+
+//---------------------------< D E G C T O R A W 1 2 >--------------------------------------------------------
+//
+// rounding to the nearest 0.0625 C and the range limits
+//
+
+static void test_degc_to_raw12 (void)
+	{
+	Test_TMP275 sensor;
+	uint16_t raw12 = 0x1234;
+	float t;
+
+	t = -55.0f;		CHECK ((SUCCESS == sensor.degCToRaw12 (&raw12, &t)) && (0xC900 == raw12));
+	t = -55.01f;	CHECK (FAIL == sensor.degCToRaw12 (&raw12, &t));
+	t = -0.03f;		CHECK ((SUCCESS == sensor.degCToRaw12 (&raw12, &t)) && (0x0000 == raw12));
+	t = -0.04f;		CHECK ((SUCCESS == sensor.degCToRaw12 (&raw12, &t)) && (0xFFF0 == raw12));
+	t = 25.5f;		CHECK ((SUCCESS == sensor.degCToRaw12 (&raw12, &t)) && (0x1980 == raw12));
+	t = 127.9375f;	CHECK ((SUCCESS == sensor.degCToRaw12 (&raw12, &t)) && (0x7FF0 == raw12));
+	t = 127.94f;	CHECK (FAIL == sensor.degCToRaw12 (&raw12, &t));
+	t = NAN;		CHECK (FAIL == sensor.degCToRaw12 (&raw12, &t));
+	t = 77.0f;		CHECK ((SUCCESS == sensor.degFToRaw12 (&raw12, &t)) && (0x1900 == raw12));
+
+	for (int16_t counts = -880; counts <= 2047; counts++)		// every code round trips
+		{
+		t = sensor.raw12_to_c ((uint16_t)(counts << 4));
+		CHECK ((SUCCESS == sensor.degCToRaw12 (&raw12, &t)) && ((uint16_t)(counts << 4) == raw12));
+		}
+	}
+
+
+//---------------------------< T H R E S H O L D S >----------------------------------------------------------
+//
+// rise at or above the setpoint, fall below setpoint - hysteresis, events in order; bad arguments rejected
+//
+
+static uint8_t events_get (Test_TMP275 &sensor, Systronix_TMP275::threshold_event_t *events, uint8_t max_events)
+	{
+	uint8_t count = 0;
+
+	while ((count < max_events) && sensor.threshold_event_get (&events[count]))
+		count++;
+	return count;
+	}
+
+static uint16_t raw_of (float c)
+	{
+	return (uint16_t)((int16_t)(c * 16.0f) << 4);
+	}
+
+static void test_thresholds (void)
+	{
+	Test_TMP275 sensor;
+	Systronix_TMP275::threshold_event_t events[TMP275_EVENTS];
+
+	sensor_start (sensor);
+
+	CHECK (FAIL == sensor.threshold_set (TMP275_THRESHOLDS, 30.0f, 1.0f));
+	CHECK (FAIL == sensor.threshold_set (0, 30.0f, -1.0f));
+	CHECK (FAIL == sensor.threshold_set (0, 30.0f, NAN));
+	CHECK (FAIL == sensor.threshold_set (0, NAN, 1.0f));
+	CHECK (FAIL == sensor.threshold_set (0, 30.0f, 1.0e30f));
+	CHECK (FAIL == sensor.threshold_set (0, -50.0f, 100.0f));			// clear point below int16 range
+	CHECK (FAIL == sensor.threshold_set (0, 200.0f, 1.0f));
+
+	CHECK (SUCCESS == sensor.threshold_set (0, 30.0f, 1.0f));			// warning
+	CHECK (SUCCESS == sensor.threshold_set (1, 50.0f, 2.0f));			// critical
+
+	sensor.read (raw_of (20.0f));
+	sensor.read (raw_of (29.9375f));
+	CHECK (0 == events_get (sensor, events, TMP275_EVENTS));
+
+	sensor.read (raw_of (30.0f));										// at setpoint: rise
+	CHECK (1 == events_get (sensor, events, TMP275_EVENTS));
+	CHECK ((0 == events[0].threshold) && events[0].rising && (raw_of (30.0f) == events[0].raw_temp));
+
+	sensor.read (raw_of (29.0f));										// inside hysteresis: nothing
+	CHECK (0 == events_get (sensor, events, TMP275_EVENTS));
+
+	sensor.read (raw_of (28.9375f));									// below 30 - 1: fall
+	CHECK (1 == events_get (sensor, events, TMP275_EVENTS));
+	CHECK ((0 == events[0].threshold) && !events[0].rising && (sensor.data.sequence == events[0].sequence));
+
+	sensor.read (raw_of (55.0f));										// both rise on one sample
+	CHECK (2 == events_get (sensor, events, TMP275_EVENTS));
+	CHECK ((0 == events[0].threshold) && events[0].rising && (1 == events[1].threshold) && events[1].rising);
+
+	sensor.read (raw_of (48.0f));										// 50 - 2: not below, nothing
+	CHECK (0 == events_get (sensor, events, TMP275_EVENTS));
+	sensor.read (raw_of (47.9375f));
+	CHECK (1 == events_get (sensor, events, TMP275_EVENTS));
+	CHECK ((1 == events[0].threshold) && !events[0].rising);
+
+	CHECK (SUCCESS == sensor.threshold_clear (0));						// cleared: no more events for 0
+	sensor.read (raw_of (-20.0f));
+	CHECK (0 == events_get (sensor, events, TMP275_EVENTS));
+
+	for (uint8_t i = 0; i < TMP275_EVENTS + 2; i++)						// queue full: extras dropped
+		sensor.read (raw_of ((i & 1) ? 60.0f : 40.0f));
+	CHECK (TMP275_EVENTS - 1 == events_get (sensor, events, TMP275_EVENTS));
+	CHECK (2 == sensor.stats.events_dropped);							// first 40 C is no crossing: 9 events
+	}
+
+
+/* ========== MAIN ========== */
+int main (void)
+	{
+	test_snapshot_stress ();
+	test_snapshot_interrupt_stress ();
+	test_snapshot_writer_isr ();
+	test_snapshot_reader_isr ();
+	test_freshness ();
+	test_steady ();
+	test_bus_counts ();
+	test_fleet_init ();
+	test_poller ();
+	test_degc_to_raw12 ();
+	test_thresholds ();
+
+	printf ("%s: %d failure(s)\n", failures ? "FAILED" : "PASSED", failures);
+	return failures ? 1 : 0;
+	}